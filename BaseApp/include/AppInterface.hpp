@@ -3,7 +3,11 @@
 #include <cstdint>
 #include <memory>
 
+#include "AppRegistry.hpp"
+#include "FrameWatchdog.hpp"
+#include "HitTester.hpp"
 #include "OscHandler.hpp"
+#include "OscRouter.hpp"
 #include "TouchInfo.hpp"
 
 #include "osc/OscReceivedElements.h"
@@ -11,8 +15,6 @@
 namespace tll
 {
 
-    typedef std::unique_ptr<class AppInterface> createApp();
-
     /* アプリ実装用インターフェースクラス */
     class AppInterface
     {
@@ -29,13 +31,37 @@ namespace tll
         virtual void onMoved(TouchInfo ti) = 0;
         virtual void onReleased(TouchInfo ti) = 0;
 
+        /* Gesture event */
+        virtual void onGesture(GestureInfo gi) {}
+
         /* Blob event */
         virtual void addBlob(BlobInfo bi) {}
         virtual void moveBlob(tll::BlobInfo bi) {}
         virtual void removeBlob(tll::BlobInfo bi) {}
 
         /* OSC process */
+        // ルートを1つも登録していないアプリにのみ呼ばれる
         virtual void procOscMessage(const osc::ReceivedMessage& msg) {}
+
+        /* OSC route */
+        OscRouter& getOscRoutes() { return this->osc_routes_; }
+
+        /* Touch region */
+        HitTester& getTouchRegions() { return this->touch_regions_; }
+
+        /* Frame budget */
+        // run()の実行中に予算の残り時間・品質レベルを参照し、処理量を調整できる
+        FrameContext& getFrameContext() { return this->frame_context_; }
+
+    protected:
+        // 登録した領域のハンドラにはonTouched等より先にタッチイベントが配送される
+        HitTester touch_regions_;
+
+        // 登録したルートに一致しないOSCメッセージはアプリに届かない
+        OscRouter osc_routes_;
+
+        // run()の呼び出し前にベースアプリが更新する
+        FrameContext frame_context_;
     };
 
 }
@@ -0,0 +1,61 @@
+/**
+ * @file    AppRegistry.hpp
+ * @brief   Static registration of apps linked into the base app
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#ifndef __APP_REGISTRY_HPP__
+#define __APP_REGISTRY_HPP__
+
+#include <memory>
+#include <vector>
+
+namespace tll
+{
+
+    typedef std::unique_ptr<class AppInterface> createApp();
+
+    /* ベースアプリに静的リンクされたアプリのファクトリ関数の一覧 */
+    class AppRegistry
+    {
+    public:
+        /* 登録されたアプリ */
+        struct Entry
+        {
+            const char* name;
+            createApp* create;
+        };
+
+        // アプリを登録する（静的変数の初期化から呼ばれる）
+        static bool add(const char* name, createApp* create);
+
+        // 登録されたアプリのファクトリ関数（無い場合はnullptr）
+        static createApp* find(const char* name);
+
+        // 登録されたアプリの一覧
+        static const std::vector<Entry>& entries();
+
+    private:
+        static std::vector<Entry>& table();
+    };
+
+}
+
+/*
+ * アプリのファクトリ関数を登録する（アプリのソースファイルに1つ記述する）
+ * 例: TLL_REGISTER_APP(Theremin, ThereminApp)
+ *
+ * TLL_STATIC_APPSを定義してビルドした場合はベースアプリの一覧に登録し、
+ * それ以外の場合はDLLから読み込むためのcreate()を定義する
+ */
+#ifdef TLL_STATIC_APPS
+#define TLL_REGISTER_APP(app_name, AppClass)                                                        \
+    static const bool tll_registered_##app_name = ::tll::AppRegistry::add(#app_name,               \
+        []() -> std::unique_ptr<::tll::AppInterface> { return std::make_unique<AppClass>(); });
+#else
+#define TLL_REGISTER_APP(app_name, AppClass)                                                        \
+    extern "C" std::unique_ptr<::tll::AppInterface> create() { return std::make_unique<AppClass>(); }
+#endif
+
+#endif
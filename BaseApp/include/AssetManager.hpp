@@ -0,0 +1,127 @@
+/**
+ * @file    AssetManager.hpp
+ * @brief   Deduplicating cache of decoded images and fonts
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#ifndef __ASSET_MANAGER_HPP__
+#define __ASSET_MANAGER_HPP__
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <opencv2/freetype.hpp>
+
+namespace tll
+{
+
+    class AssetPack;
+    class Image;
+
+    /* 読み込んだフォント */
+    struct Font
+    {
+        cv::Ptr<cv::freetype::FreeType2> ft2;
+    };
+
+    /* 資産キャッシュの使用状況 */
+    struct AssetStats
+    {
+        uint32_t entries;
+        uint64_t bytes;        // 読み込み済みの資産の推定使用量
+        uint64_t hits;         // 読み込み済み（または読み込み中）の資産を返した回数
+        uint64_t misses;       // ファイルから読み込んだ回数
+        uint64_t evictions;    // 使用量の上限を超えたため解放した回数
+    };
+
+    /* 画像・フォントを1度だけ読み込み、参照カウント付きで共有するインターフェースクラス */
+    class IAssetManager
+    {
+    public:
+        virtual ~IAssetManager() = default;
+
+        // インスタンスを作成
+        static IAssetManager* create();
+
+        // 画像を取得する（大きさが0の場合は元の大きさ、読み込めない場合はnullptr）
+        virtual std::shared_ptr<const Image> getImage(const std::string& path, uint16_t width = 0, uint16_t height = 0) = 0;
+
+        // フォントを取得する
+        virtual std::shared_ptr<Font> getFont(const std::string& path) = 0;
+
+        // 資産パックをマップして取得する（読み込めない場合はnullptr）
+        virtual std::shared_ptr<const AssetPack> getPack(const std::string& path) = 0;
+
+        // 画像を裏のスレッドで読み込んでおく
+        virtual void warm(const std::vector<std::string>& paths) = 0;
+
+        // 使用量の上限[byte]を設定する（超えた場合はどこからも参照されていない資産を古い順に解放する）
+        virtual void setMemoryBudget(uint64_t bytes) = 0;
+
+        virtual AssetStats getStats() = 0;
+    };
+
+    /* パスと変換後の形式をキーとする資産キャッシュ */
+    class AssetManager : public IAssetManager
+    {
+    public:
+        AssetManager() noexcept;
+        ~AssetManager() override;
+
+        std::shared_ptr<const Image> getImage(const std::string& path, uint16_t width = 0, uint16_t height = 0) override;
+        std::shared_ptr<Font> getFont(const std::string& path) override;
+        std::shared_ptr<const AssetPack> getPack(const std::string& path) override;
+
+        void warm(const std::vector<std::string>& paths) override;
+
+        void setMemoryBudget(uint64_t bytes) override;
+
+        AssetStats getStats() override;
+
+    private:
+        // 読み込み関数は資産と推定使用量を返す（失敗時はnullptr）
+        using Loader = std::function<std::shared_ptr<void>(uint64_t& bytes)>;
+
+        /* キャッシュの要素（読み込み中の場合は他のスレッドが完了を待つ） */
+        struct Entry
+        {
+            std::shared_future<std::shared_ptr<void>> value;
+            uint64_t bytes = 0;
+            uint64_t last_use = 0;
+        };
+
+        // キーに対応する資産を返す（未読み込みの場合は呼び出したスレッドで読み込む）
+        std::shared_ptr<void> acquire(const std::string& key, const Loader& load);
+
+        // 使用量が上限を超えている間、参照されていない資産を古い順に解放する（ロック中に呼ぶ）
+        void evict();
+
+        void threadWarm();
+
+        std::unordered_map<std::string, Entry> entries_;
+        std::mutex mutex_;
+
+        uint64_t budget_;
+        uint64_t use_clock_;
+        AssetStats stats_;
+
+        // 裏で読み込む画像のパス
+        std::deque<std::string> warm_queue_;
+        std::condition_variable warm_cv_;
+        std::thread warm_thread_;
+        bool stop_;
+    };
+
+}
+
+#endif
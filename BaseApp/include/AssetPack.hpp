@@ -0,0 +1,214 @@
+/**
+ * @file    AssetPack.hpp
+ * @brief   Memory-mapped asset pack (.tllpak) of panel-native images and glyphs
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#ifndef __ASSET_PACK_HPP__
+#define __ASSET_PACK_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "Color.hpp"
+#include "PanelManager.hpp"
+
+namespace tll
+{
+
+    /*
+     * .tllpak の形式（リトルエンディアン、各データは8バイト境界に置く）
+     *
+     *   Header
+     *   画像: 画素（RGB、width * height * 3バイト）、マスク（width方向に64ビット単位、height行）
+     *   フォント: Glyphの表（コードポイント順）、各グリフのマスク
+     *   Entryの表（header.index_offsetから entry_count 個）
+     */
+    namespace pak
+    {
+        // ファイルの識別子
+        constexpr char MAGIC[8] = { 'T', 'L', 'L', 'P', 'A', 'K', '\0', '\0' };
+        constexpr uint32_t VERSION = 1;
+
+        // 資産名の最大長（終端を含む）
+        constexpr size_t NAME_SIZE = 48;
+
+        // データの境界
+        constexpr uint64_t ALIGN = 8;
+
+        /* 資産の種類 */
+        enum class EEntry : uint8_t
+        {
+            IMAGE,
+            FONT,
+        };
+
+        struct Header
+        {
+            char magic[8];
+            uint32_t version;
+            uint32_t entry_count;
+            uint64_t index_offset;
+        };
+
+        struct Entry
+        {
+            char name[NAME_SIZE];
+            EEntry type;
+            uint8_t reserved[3];
+            uint32_t count;          // フォント: グリフ数
+            uint16_t width;          // 画像: 幅
+            uint16_t height;         // 画像: 高さ / フォント: 行の高さ
+            uint16_t words;          // 画像: マスクの1行あたりのワード数
+            uint16_t reserved2;
+            uint64_t data_offset;    // 画像: 画素 / フォント: Glyphの表
+            uint64_t mask_offset;    // 画像: マスク
+        };
+
+        struct Glyph
+        {
+            uint32_t codepoint;
+            uint16_t width;
+            uint16_t height;
+            uint16_t advance;    // 次の文字までの幅
+            uint16_t words;
+            uint32_t reserved;
+            uint64_t mask_offset;
+        };
+
+        static_assert(sizeof(Color) == 3, "Pixels are stored as packed RGB");
+        static_assert(sizeof(Header) == 24, "Unexpected header layout");
+        static_assert(sizeof(Entry) == 80, "Unexpected entry layout");
+        static_assert(sizeof(Glyph) == 24, "Unexpected glyph layout");
+
+        inline uint64_t align(uint64_t offset) noexcept
+        {
+            return (offset + ALIGN - 1) & ~(ALIGN - 1);
+        }
+
+        // UTF-8の文字列から1文字を読み出してposを進める（不正なバイトは1バイト読み飛ばしてfalseを返す）
+        inline bool decodeUtf8(const std::string& str, size_t& pos, uint32_t& codepoint) noexcept
+        {
+            uint8_t c = static_cast<uint8_t>(str[pos++]);
+            uint32_t follow = 0;
+
+            if (c < 0x80)
+            {
+                codepoint = c;
+                return true;
+            }
+            else if ((c & 0xE0) == 0xC0) { codepoint = c & 0x1F; follow = 1; }
+            else if ((c & 0xF0) == 0xE0) { codepoint = c & 0x0F; follow = 2; }
+            else if ((c & 0xF8) == 0xF0) { codepoint = c & 0x07; follow = 3; }
+            else
+                return false;
+
+            if (pos + follow > str.size())
+                return false;
+
+            for (uint32_t i = 0; i < follow; i++)
+            {
+                uint8_t next = static_cast<uint8_t>(str[pos + i]);
+                if ((next & 0xC0) != 0x80)
+                    return false;
+
+                codepoint = (codepoint << 6) | (next & 0x3F);
+            }
+
+            pos += follow;
+            return true;
+        }
+    }
+
+    class AssetPack;
+
+    /* パック内の画像（マップした領域を直接参照する） */
+    struct PackImage
+    {
+        SurfaceView surface;
+        MaskView mask;
+
+        // 参照している間はパックのマップを解放させない
+        std::shared_ptr<const AssetPack> pack;
+
+        // 指定座標に画像を表示
+        void draw(int32_t x, int32_t y) const;
+
+        // 指定座標に色を付けて画像を表示
+        void draw(int32_t x, int32_t y, Color color) const;
+
+        // 指定座標に画像の色の付いたピクセルだけを表示
+        void drawTransparent(int32_t x, int32_t y) const;
+
+        // 指定座標に画像の色の付いたピクセルだけを指定色で表示
+        void drawTransparent(int32_t x, int32_t y, Color color) const;
+    };
+
+    /* パック内のラスタライズ済みフォント */
+    struct PackFont
+    {
+        const uint8_t* base = nullptr;
+        const pak::Glyph* glyphs = nullptr;
+        uint32_t count = 0;
+        uint16_t line_height = 0;
+
+        // 参照している間はパックのマップを解放させない
+        std::shared_ptr<const AssetPack> pack;
+
+        // コードポイントに対応するグリフ（含まれていない場合はnullptr）
+        const pak::Glyph* find(uint32_t codepoint) const noexcept;
+
+        // 文字列を左上を基準に表示し、描画した幅を返す（含まれていない文字は飛ばす）
+        uint32_t drawText(const std::string& text, int32_t x, int32_t y, Color color) const;
+
+        // 文字列の表示幅
+        uint32_t textWidth(const std::string& text) const noexcept;
+    };
+
+    /* .tllpak ファイルを読み取り専用でマップし、名前で資産を引く */
+    class AssetPack : public std::enable_shared_from_this<AssetPack>
+    {
+    public:
+        AssetPack() noexcept;
+        ~AssetPack();
+
+        AssetPack(const AssetPack&) = delete;
+        AssetPack& operator=(const AssetPack&) = delete;
+
+        // ファイルをマップして目次を読み込む（形式が不正な場合はfalse）
+        bool open(const std::string& path);
+
+        void close() noexcept;
+
+        bool isOpen() const noexcept { return this->data_ != nullptr; }
+
+        // マップしたファイルの大きさ
+        size_t size() const noexcept { return this->size_; }
+
+        // 名前に対応する画像・フォントを取得する（見つからない場合はfalse）
+        // shared_ptrで保持されたパックから取得した場合、画像・フォントがパックへの参照を持つ
+        bool findImage(const std::string& name, PackImage& image) const;
+        bool findFont(const std::string& name, PackFont& font) const;
+
+    private:
+        // 範囲がファイルに収まっているか
+        bool contains(uint64_t offset, uint64_t bytes) const noexcept;
+
+        // 目次の各要素がファイルに収まっているか
+        bool validate(const pak::Entry& entry) const noexcept;
+
+        const pak::Entry* lookup(const std::string& name, pak::EEntry type) const;
+
+        const uint8_t* data_;
+        size_t size_;
+
+        std::unordered_map<std::string, const pak::Entry*> index_;
+    };
+
+}
+
+#endif
@@ -1,22 +1,44 @@
 #pragma once
 
 #include "TLL.h"
+#include "tllEngine.hpp"
 #include "AppInterface.hpp"
+#include "Compositor.hpp"
+#include "FrameWatchdog.hpp"
+#include "Gesture.hpp"
+#include "LatencyTracer.hpp"
+#include "TouchPredictor.hpp"
 
 #include <TuioListener.h>
-#include <UdpReceiver.h>
+#include <OscReceiver.h>
 #include <TuioClient.h>
 
+#include <array>
+#include <atomic>
 #include <iostream>
 #include <unistd.h>
 #include <thread>
 #include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <utility>
 #include <vector>
 #include <unordered_map>
 #include <memory>
+#include <mutex>
+#include <string>
 
 namespace tll
 {
+    /* アプリ切り替えにかかった時間 */
+    struct SwitchStats
+    {
+        uint64_t count;
+        uint32_t last_us;         // 切り替え要求から入れ替えまで
+        uint32_t max_us;
+        uint32_t last_init_us;    // 裏で行った作成・初期化にかかった時間
+    };
+
     /* アプリを動作させるためのアプリクラス */
     class BaseApp : public TUIO::TuioListener
     {
@@ -26,123 +48,144 @@ namespace tll
 
         void addTuioObject(TUIO::TuioObject *tobj) override
         {
+            std::lock_guard<std::mutex> lock(this->app_mutex_);
+
+            TouchInfo ti{
+                static_cast<uint32_t>(tobj->getSymbolID()),
+                static_cast<int32_t>(tobj->getX()),
+                static_cast<int32_t>(tobj->getY())
+            };
+            ti.frame_time = frameTime(tobj);
+
+            this->traceReceived(ti);
+
+            this->gesture_.touch(ti);
+            ti = this->predictor_.touch(ti);
+
+            // ビューポートのアプリに捕捉されたタッチはそのアプリにだけ配送する
+            if (this->dispatchViewport(ETouchEvent::TOUCHED, ti))
+            {
+                TLL_ENGINE(LatencyTracer)->mark(ti.id, ETraceStage::APP_HANDLED);
+                return;
+            }
+
             if (this->is_home_)
             {
-                int32_t x = static_cast<int32_t>(tobj->getX());
-                int32_t y = static_cast<int32_t>(tobj->getY());
+                uint16_t hit = this->home_regions_.hitTest(ti.raw_x, ti.raw_y);
 
-                if (8 <= y && y <= 22)
-                {
-                    this->icon_pressed[0] = ( 3 <= x && x <= 17);
-                    this->icon_pressed[1] = (24 <= x && x <= 38);
-                    this->icon_pressed[2] = (45 <= x && x <= 59);
-                }
+                for (int i = 0; i < 3; i++)
+                    this->icon_pressed[i] = (hit != HitTester::NONE && hit == this->icon_region_[i]);
 
+                TLL_ENGINE(LatencyTracer)->mark(ti.id, ETraceStage::APP_HANDLED);
                 return;
             }
 
-            if (this->running_app)
+            if (this->running_app && !this->paused_)
             {
-                this->running_app->onTouched(
-                    TouchInfo{
-                        static_cast<uint32_t>(tobj->getSymbolID()),
-                        static_cast<int32_t>(tobj->getX()),
-                        static_cast<int32_t>(tobj->getY())
-                    }
-                );
+                this->running_app->getTouchRegions().dispatch(ETouchEvent::TOUCHED, ti);
+                this->running_app->onTouched(ti);
+                this->delivered_num_++;
             }
+
+            TLL_ENGINE(LatencyTracer)->mark(ti.id, ETraceStage::APP_HANDLED);
         }
 
         void updateTuioObject(TUIO::TuioObject *tobj) override
         {
+            std::lock_guard<std::mutex> lock(this->app_mutex_);
+
+            TouchInfo ti{
+                static_cast<uint32_t>(tobj->getSymbolID()),
+                static_cast<int32_t>(tobj->getX()),
+                static_cast<int32_t>(tobj->getY())
+            };
+            ti.frame_time = frameTime(tobj);
+
+            this->traceReceived(ti);
+
+            this->gesture_.move(ti);
+            ti = this->predictor_.move(ti);
+
+            // ビューポートのアプリに捕捉されたタッチはそのアプリにだけ配送する
+            if (this->dispatchViewport(ETouchEvent::MOVED, ti))
+            {
+                TLL_ENGINE(LatencyTracer)->mark(ti.id, ETraceStage::APP_HANDLED);
+                return;
+            }
+
             if (this->is_home_)
             {
-                int32_t x = static_cast<int32_t>(tobj->getX());
-                int32_t y = static_cast<int32_t>(tobj->getY());
+                uint16_t hit = this->home_regions_.hitTest(ti.raw_x, ti.raw_y);
 
-                if (8 <= y && y <= 22)
-                {
-                    this->icon_pressed[0] = ( 3 <= x && x <= 17);
-                    this->icon_pressed[1] = (24 <= x && x <= 38);
-                    this->icon_pressed[2] = (45 <= x && x <= 59);
-                }
-                else
-                {
-                    for (int i = 0; i < 3; i++)
-                        this->icon_pressed[i] = false;
-                }
+                for (int i = 0; i < 3; i++)
+                    this->icon_pressed[i] = (hit != HitTester::NONE && hit == this->icon_region_[i]);
 
+                TLL_ENGINE(LatencyTracer)->mark(ti.id, ETraceStage::APP_HANDLED);
                 return;
             }
 
-            if (this->running_app)
+            if (this->running_app && !this->paused_)
             {
-                this->running_app->onMoved(
-                    TouchInfo{
-                        static_cast<uint32_t>(tobj->getSymbolID()),
-                        static_cast<int32_t>(tobj->getX()),
-                        static_cast<int32_t>(tobj->getY())
-                    }
-                );
+                this->running_app->getTouchRegions().dispatch(ETouchEvent::MOVED, ti);
+                this->running_app->onMoved(ti);
+                this->delivered_num_++;
             }
+
+            TLL_ENGINE(LatencyTracer)->mark(ti.id, ETraceStage::APP_HANDLED);
         }
 
         void removeTuioObject(TUIO::TuioObject *tobj) override
         {
+            std::lock_guard<std::mutex> lock(this->app_mutex_);
+
+            TouchInfo ti{
+                static_cast<uint32_t>(tobj->getSymbolID()),
+                static_cast<int32_t>(tobj->getX()),
+                static_cast<int32_t>(tobj->getY())
+            };
+            ti.frame_time = frameTime(tobj);
+
+            this->traceReceived(ti);
+
+            this->gesture_.release(ti);
+            ti = this->predictor_.release(ti);
+
+            // ビューポートのアプリに捕捉されたタッチはそのアプリにだけ配送する
+            if (this->dispatchViewport(ETouchEvent::RELEASED, ti))
+            {
+                TLL_ENGINE(LatencyTracer)->mark(ti.id, ETraceStage::APP_HANDLED);
+                return;
+            }
+
             if (this->is_home_)
             {
-                int32_t x = static_cast<int32_t>(tobj->getX());
-                int32_t y = static_cast<int32_t>(tobj->getY());
+                uint16_t hit = this->home_regions_.hitTest(ti.raw_x, ti.raw_y);
 
-                if (8 <= y && y <= 22)
+                // 離した位置のアイコンのアプリを起動する
+                for (int i = 0; i < 3; i++)
                 {
-                    if (3 <= x && x <= 17)
-                    {
-                        this->is_playing_anim = 0;
-                    }
-                    else
-                    {
-                        this->icon_pressed[0] = false;
-                    }
-
-                    if (24 <= x && x <= 38)
-                    {
-                        this->is_playing_anim = 1;
-                    }
-                    else
-                    {
-                        this->icon_pressed[1] = false;
-                    }
-
-                    if (45 <= x && x <= 59)
+                    if (hit != HitTester::NONE && hit == this->icon_region_[i])
                     {
-                        this->is_playing_anim = 2;
+                        // 開始時アニメーションの間に裏でアプリを初期化しておく（準備はメインループで始める）
+                        this->is_playing_anim = i;
+                        this->requestPrepare(HOME_APPS[i]);
                     }
                     else
-                    {
-                        this->icon_pressed[2] = false;
-                    }
-                }
-                else
-                {
-                    for (int i = 0; i < 3; i++)
                         this->icon_pressed[i] = false;
                 }
 
+                TLL_ENGINE(LatencyTracer)->mark(ti.id, ETraceStage::APP_HANDLED);
                 return;
             }
 
-            if (this->running_app)
+            if (this->running_app && !this->paused_)
             {
-                this->running_app->onReleased(
-                    TouchInfo
-                    {
-                        static_cast<uint32_t>(tobj->getSymbolID()),
-                        static_cast<int32_t>(tobj->getX()),
-                        static_cast<int32_t>(tobj->getY())
-                    }
-                );
+                this->running_app->getTouchRegions().dispatch(ETouchEvent::RELEASED, ti);
+                this->running_app->onReleased(ti);
+                this->delivered_num_++;
             }
+
+            TLL_ENGINE(LatencyTracer)->mark(ti.id, ETraceStage::APP_HANDLED);
         }
 
         void addTuioCursor(TUIO::TuioCursor *tcur) override {}
@@ -151,6 +194,12 @@ namespace tll
         
         void addTuioBlob(TUIO::TuioBlob *tblb) override
         {
+            std::lock_guard<std::mutex> lock(this->app_mutex_);
+
+            // ホーム画面表示中・一時停止中は配送しない
+            if (!this->running_app || this->paused_)
+                return;
+
             this->running_app->addBlob(
                 BlobInfo
                 {
@@ -161,10 +210,17 @@ namespace tll
                     static_cast<int32_t>(tblb->getHeight())
                 }
             );
+            this->delivered_num_++;
         }
 
         void updateTuioBlob(TUIO::TuioBlob *tblb) override
         {
+            std::lock_guard<std::mutex> lock(this->app_mutex_);
+
+            // ホーム画面表示中・一時停止中は配送しない
+            if (!this->running_app || this->paused_)
+                return;
+
             this->running_app->moveBlob(
                 BlobInfo
                 {
@@ -175,10 +231,17 @@ namespace tll
                     static_cast<int32_t>(tblb->getHeight())
                 }
             );
+            this->delivered_num_++;
         }
 
         void removeTuioBlob(TUIO::TuioBlob *tblb) override
         {
+            std::lock_guard<std::mutex> lock(this->app_mutex_);
+
+            // ホーム画面表示中・一時停止中は配送しない
+            if (!this->running_app || this->paused_)
+                return;
+
             this->running_app->removeBlob(
                 BlobInfo
                 {
@@ -189,22 +252,189 @@ namespace tll
                     static_cast<int32_t>(tblb->getHeight())
                 }
             );
+            this->delivered_num_++;
         }
 
         void refresh(TUIO::TuioTime ftime) override {}
 
+        // タッチ点を更新したTUIOフレームの時刻[us]
+        static uint64_t frameTime(TUIO::TuioObject* tobj)
+        {
+            TUIO::TuioTime t = tobj->getTuioTime();
+            return static_cast<uint64_t>(t.getSeconds()) * 1000000 + static_cast<uint64_t>(t.getMicroseconds());
+        }
+
         void run();
+
+        // アプリの切り替えを要求する（切り替えは準備の完了後、次のフレームの開始時に行われる、メインループからのみ呼ぶ）
         bool switchApp(const std::string app_name);
 
+        // アプリを裏で作成しておく（起動中のアプリはそのまま動作を続ける、メインループからのみ呼ぶ、準備の完了は待たない）
+        // 起動中のアプリが無い場合は初期化まで裏で済ませ、ある場合は旧アプリの終了後に切り替え時に初期化する
+        bool prepareApp(const std::string& app_name);
+
+        // アプリの準備を要求する（他のスレッドから呼べる、準備は次のフレームの開始時に始まる）
+        void requestPrepare(const std::string& app_name);
+
+        // 起動中のアプリにOSCメッセージを配送する
+        void procOscMessage(const osc::ReceivedMessage& msg);
+
         AppInterface* getRunningApp() { return this->running_app.get(); }
 
+        // アプリ切り替えにかかった時間の統計
+        SwitchStats getSwitchStats();
+
+        // ビューポートでアプリを起動する（起動中のアプリの上に重ねて表示され、専用のスレッドで描画される）
+        // パネルからはみ出した部分は切り取られる（パネル内に残らない場合はfalse）
+        bool openViewport(const std::string& app_name, const Viewport& requested);
+
+        // ビューポートのアプリを終了する
+        bool closeViewport(const std::string& app_name);
+
+        TouchPredictor& getTouchPredictor() { return this->predictor_; }
+
+        FrameWatchdog& getFrameWatchdog() { return this->watchdog_; }
+
+        // 毎秒のイベント配送数を表示するか設定する
+        void setEventCount(bool enable) { this->count_events_ = enable; }
+
+        // 赤外線センサ画像の受信先を設定する（空の場合は外部プロセスのOSCを使う）
+        void setIrSensor(std::string endpoint) { this->ir_endpoint_ = endpoint; }
+
+        // アプリをそれぞれ子プロセスで動かすか設定する
+        void setIsolateApps(bool enable) { this->isolate_apps_ = enable; }
+
+        // 最初のフレームの表示後に裏で読み込んでおくアプリ数を設定する（起動回数の多い順）
+        void setPreloadApps(uint32_t num) { this->preload_num_ = num; }
+
     private:
+        /* 登録済みのアプリ（DLLは初めて起動する時に読み込む） */
+        struct AppEntry
+        {
+            std::shared_ptr<void> handle;       // 参照が無くなった時点でDLLを解放する（未読み込みの場合はnull）
+            createApp* create = nullptr;        // 読み込み時に解決したファクトリ関数
+            std::filesystem::path path;         // DLLのファイル
+            std::string symbol = "create";      // ファクトリ関数名
+            std::string icon;                   // アイコン画像（無い場合は空）
+            uint32_t launches = 0;              // 起動回数（先読みするアプリの選択に使う）
+            bool demoted = false;               // 処理落ちが続いたため子プロセスで動かす
+        };
+
+        /* ビューポートで動作するアプリ */
+        struct ViewportApp
+        {
+            std::string name;
+            std::shared_ptr<void> handle;
+            std::unique_ptr<class AppInterface> app;
+            uint16_t layer;
+
+            std::thread thread;
+            std::atomic<bool> stop{false};
+
+            // TUIOスレッドから受け取り、ビューポートのスレッドで配送するタッチイベント
+            std::vector<std::pair<ETouchEvent, TouchInfo>> events;
+            std::mutex event_mutex;
+        };
+
+        // ホーム画面のアイコンから起動するアプリ
+        static constexpr const char* HOME_APPS[3] = { "CockroachShooting", "Theremin", "ADIR01P_Light" };
+
+        // アプリの一覧（名前、DLL、アイコン、ファクトリ関数名、起動回数）
+        static constexpr const char* APP_INDEX = "./app/apps.index";
+
+        // ホーム画面へ戻る操作（5点を3秒置いたままにする）
+        static constexpr uint32_t HOME_HOLD_FINGERS = 5;
+        static constexpr uint32_t HOME_HOLD_TIME    = 3000;
+
+        // 一覧とディレクトリからアプリを登録する（DLLは読み込まない）
         uint32_t loadApps();
 
+        // 起動回数を含めたアプリの一覧を保存する
+        void saveAppIndex();
+
+        // 未読み込みであればDLLを読み込み、登録済みのエントリを返す
+        bool loadApp(const std::string& app_name, AppEntry& entry);
+
+        // 起動回数の多いアプリのDLLを裏で読み込んでおく
+        void threadPreloadApps();
+
+        // prepareApp()で依頼されたアプリを作成する（処理中に届いた依頼は最新のものだけを次に処理する）
+        void threadPrepareApps();
+
+        // アプリのDLLを版数付きの別名で読み込む（同じアプリの新旧版を同時に読み込めるようにする）
+        static bool openApp(AppEntry& entry);
+
+        // アプリのインスタンスを作成する（子プロセスで動かす場合は代理アプリを返す）
+        std::unique_ptr<class AppInterface> createAppInstance(const AppEntry& entry);
+
+        // アプリのディレクトリを監視し、更新されたDLLを読み込む
+        void threadWatchApps();
+
+        // 読み込み直したアプリを登録し、起動中であれば新しい版に切り替える
+        void applyReloads();
+
+        // 起動中アプリのフレーム予算の監視結果に対応する
+        void applyBudgetAction(EBudgetAction action);
+
+        // アイコンの押下状態（ビットiがアイコンiの押下）に対応するホーム画面を焼き込む
+        void bakeLauncherLayer(uint8_t pressed);
+
+        // コマンドバスに溜まった制御コマンドを適用する
+        void applyCommands();
+
+        // 要求されたアプリの準備ができていれば起動中のアプリと入れ替える
+        void applySwitch();
+
+        // ビューポートのアプリを画面外バッファに描画し続ける
+        void threadViewportApp(ViewportApp* vp);
+
+        // タッチ点を含むビューポートのアプリにイベントを配送する（配送した場合はtrue）
+        bool dispatchViewport(ETouchEvent event, TouchInfo ti);
+
+        // ビューポートの描画結果をパネルに合成し、次のフレームの描画を始めさせる
+        void composeViewports();
+
+        // TUIOで受信したタッチ点にOSC受信時のトレース情報を付ける
+        void traceReceived(TouchInfo& ti)
+        {
+            TLL_ENGINE(LatencyTracer)->mark(ti.id, ETraceStage::TUIO_RECEIVED);
+            TLL_ENGINE(LatencyTracer)->lookup(ti.id, ti.trace_id, ti.timestamp);
+        }
+
         // 読み込んだ（アプリ名 - DLL）のリスト
-        std::unordered_map<std::string, void*> app_list;
+        std::unordered_map<std::string, AppEntry> app_list;
 
+        // アプリのインスタンスより後に解放されるよう、DLLの参照を先に宣言する
+        std::shared_ptr<void> running_handle_;
+        std::string running_name_;
         std::unique_ptr<class AppInterface> running_app;
+        std::mutex app_mutex_;    // 入れ替え中にイベントが配送されないようにする
+
+        // 裏で準備したアプリと切り替え要求
+        std::shared_ptr<void> prepared_handle_;
+        std::unique_ptr<class AppInterface> prepared_app_;
+        bool prepared_inited_ = false;    // 準備中にinit()を済ませたか
+        Surface prepared_surface_;        // 準備中のinit()で描画された画面（切り替え時にパネルへ転送する）
+        std::string prepared_name_;
+        std::string prepare_request_;
+        std::string pending_name_;
+        std::chrono::steady_clock::time_point switch_request_tp_;
+        uint32_t prepare_init_us_ = 0;
+        SwitchStats switch_stats_{};
+        std::mutex switch_mutex_;
+
+        // 準備用のスレッドへの依頼（switch_mutex_で守る、未着手の依頼は新しい依頼で置き換える）
+        struct PrepareJob
+        {
+            std::string name;
+            AppEntry entry;
+            bool init_now = false;
+        };
+        PrepareJob prepare_job_;
+        bool prepare_job_pending_ = false;
+        bool prepare_stop_ = false;
+        std::condition_variable prepare_cv_;
+        std::thread prepare_thread_;
 
         TUIO::TuioClient* tuio_client;
         TUIO::OscReceiver* osc_receiver;
@@ -214,11 +444,59 @@ namespace tll
 
         bool icon_pressed[3] = { false, false, false };
 
-        bool back_to_home_flag = false;
-        std::chrono::system_clock::time_point back_to_home_tp;
+        // アイコンの押下状態ごとに焼き込んだホーム画面と、パネルに表示中の押下状態
+        static constexpr uint8_t LAUNCHER_DIRTY = 0xFF;    // 描き直しが必要
+        std::array<Surface, 8> launcher_layers_;
+        uint8_t launcher_shown_ = LAUNCHER_DIRTY;
+
+        // ホーム画面のアイコン領域
+        HitTester home_regions_;
+        uint16_t icon_region_[3] = { HitTester::NONE, HitTester::NONE, HitTester::NONE };
+
+        // タッチイベントからのジェスチャ判定
+        GestureRecognizer gesture_;
+        bool home_held_ = false;    // 5点ホールドでホームへの切り替えを要求済み
+
+        // タッチ位置の平滑化・先読み予測
+        TouchPredictor predictor_;
+
+        // 起動中アプリのフレーム予算の監視
+        FrameWatchdog watchdog_;
 
         // アニメーション用フラグ
         int8_t is_playing_anim = -1;
+
+        // 起動中アプリの一時停止（描画とイベント配送を止める）
+        std::atomic<bool> paused_{false};
+
+        // アプリに配送したタッチ・領域イベント数
+        std::atomic<uint64_t> delivered_num_{0};
+        bool count_events_ = false;
+
+        // 赤外線センサ画像の受信先（ZeroMQ）
+        std::string ir_endpoint_;
+
+        // アプリを子プロセスで動かすか（異常終了・処理落ちが他のアプリに波及しない）
+        bool isolate_apps_ = false;
+
+        // 裏で読み込んでおくアプリ数
+        uint32_t preload_num_ = 2;
+        std::thread preload_thread_;
+
+        // ビューポートで動作中のアプリと、タッチ点を捕捉しているアプリ
+        std::vector<std::unique_ptr<ViewportApp>> viewport_apps_;
+        std::unordered_map<uint32_t, ViewportApp*> touch_owner_;
+        Compositor compositor_;
+
+        // ビューポートのアプリにフレームの開始を知らせる
+        uint64_t frame_count_ = 0;
+        std::mutex frame_mutex_;
+        std::condition_variable frame_cv_;
+
+        // 更新を検知して読み込み直したアプリ
+        std::vector<std::pair<std::string, AppEntry>> reloaded_apps_;
+        std::mutex reload_mutex_;
+        std::thread watch_thread_;
     };
 
 }
@@ -0,0 +1,126 @@
+/**
+ * @file    BlobDetector.hpp
+ * @brief   IR sensor frame blob detection
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#ifndef __BLOB_DETECTOR_HPP__
+#define __BLOB_DETECTOR_HPP__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tll
+{
+
+    /* 赤外線センサ画像から検出したタッチ領域 */
+    struct DetectedBlob
+    {
+        uint32_t id;
+
+        // 外接矩形
+        int32_t x;
+        int32_t y;
+        int32_t w;
+        int32_t h;
+
+        // 重心
+        int32_t cx;
+        int32_t cy;
+
+        uint32_t area;
+    };
+
+    /* 赤外線センサの輝度画像からタッチ領域を検出・追跡するクラス */
+    class BlobDetector
+    {
+    public:
+        BlobDetector() noexcept;
+
+        // センサ解像度で作業領域を確保する
+        void init(uint16_t width, uint16_t height);
+
+        // 1フレームを処理し、タッチ領域を更新する（背景学習中はfalse）
+        bool process(const uint8_t* frame);
+
+        // 背景を学習し直す
+        void resetBackground();
+
+        // 現在追跡中のタッチ領域
+        const std::vector<DetectedBlob>& getBlobs() const noexcept { return this->blobs_; }
+
+        // 前回clearRemovedIds()を呼んでから消えたタッチ領域のID（背景の学習し直しで消えたものを含む）
+        const std::vector<uint32_t>& getRemovedIds() const noexcept { return this->removed_ids_; }
+
+        // 消えたタッチ領域のIDを通知し終えた際に呼ぶ
+        void clearRemovedIds() noexcept { this->removed_ids_.clear(); }
+
+        uint16_t getWidth()  const noexcept { return this->width_;  }
+        uint16_t getHeight() const noexcept { return this->height_; }
+
+        // 背景との差分がこの値を超えたピクセルをタッチとみなす
+        uint8_t threshold = 32;
+
+        // この面積[px]未満の領域はノイズとして捨てる
+        uint32_t min_area = 2;
+
+        // 前フレームの領域と同一とみなす重心の最大移動量[px]
+        int32_t max_distance = 6;
+
+        // 背景学習に使うフレーム数
+        uint32_t background_frames = 30;
+
+    private:
+        // 背景差分と二値化を行う
+        void subtractBackground(const uint8_t* frame);
+
+        // 連結成分にラベルを付け、領域ごとの統計を求める
+        void labelComponents();
+
+        // 前フレームの領域と対応付けてIDを割り当てる
+        void track();
+
+        uint32_t findRoot(uint32_t label);
+
+        uint16_t width_;
+        uint16_t height_;
+
+        // 背景画像と学習用の積算値
+        std::vector<uint8_t> background_;
+        std::vector<uint32_t> background_sum_;
+        uint32_t learned_frames_;
+
+        // 前景マスク（0xFF:前景）
+        std::vector<uint8_t> mask_;
+
+        // ピクセルごとのラベルと、ラベルの併合先
+        std::vector<uint32_t> labels_;
+        std::vector<uint32_t> parent_;
+
+        // ラベルごとの統計
+        struct Component
+        {
+            int32_t min_x, min_y, max_x, max_y;
+            uint64_t sum_x, sum_y;
+            uint32_t area;
+        };
+        std::vector<Component> components_;
+
+        // 今回のフレームで検出した領域（ID未割り当て）
+        std::vector<DetectedBlob> detected_;
+
+        std::vector<DetectedBlob> blobs_;
+        std::vector<uint32_t> removed_ids_;
+        std::vector<bool> matched_;
+
+        uint32_t next_id_;
+    };
+
+    // 赤外線センサ画像をZeroMQで受信し、検出したタッチをイベントハンドラに渡す
+    void threadReceiveIrFrame(std::string endpoint);
+
+}
+
+#endif
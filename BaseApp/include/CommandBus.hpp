@@ -0,0 +1,105 @@
+/**
+ * @file    CommandBus.hpp
+ * @brief   Lock-free command queue applied at frame boundaries
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#ifndef __COMMAND_BUS_HPP__
+#define __COMMAND_BUS_HPP__
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace tll
+{
+
+    /* 制御コマンドの種類 */
+    enum class ECommand : uint8_t
+    {
+        SWITCH_APP,        // アプリ切り替え（app_name）
+        PAUSE,             // 起動中アプリの一時停止
+        RESUME,            // 一時停止の解除
+        TOGGLE_PAUSE,      // 一時停止の切り替え
+        SET_BRIGHTNESS,    // 輝度設定（value: 0〜255）
+        OPEN_VIEWPORT,     // ビューポートでアプリを起動（app_name, rect）
+        CLOSE_VIEWPORT,    // ビューポートのアプリを終了（app_name）
+    };
+
+    /* 制御コマンド */
+    struct Command
+    {
+        ECommand type;
+        int32_t value;
+        char app_name[48];
+        int16_t rect[4];    // x, y, w, h
+    };
+
+    /* 任意のスレッドから制御コマンドを受け付け、メインループで取り出すインターフェースクラス */
+    class ICommandBus
+    {
+    public:
+        virtual ~ICommandBus() = default;
+
+        // インスタンスを作成
+        static ICommandBus* create();
+
+        // コマンドを追加する（キューが一杯の場合はfalse）
+        virtual bool post(const Command& cmd) = 0;
+
+        // コマンドを1つ取り出す（メインループからのみ呼ぶ）
+        virtual bool poll(Command& cmd) = 0;
+
+        // アプリ切り替えを要求する
+        bool postSwitchApp(const std::string& app_name);
+
+        // 一時停止・再開を要求する
+        bool postPause(bool pause);
+
+        // 一時停止の切り替えを要求する
+        bool postTogglePause();
+
+        // 輝度の変更を要求する
+        bool postBrightness(uint8_t brightness);
+
+        // ビューポートでのアプリの起動を要求する
+        bool postOpenViewport(const std::string& app_name, int16_t x, int16_t y, int16_t w, int16_t h);
+
+        // ビューポートのアプリの終了を要求する
+        bool postCloseViewport(const std::string& app_name);
+    };
+
+    /* 固定長リングバッファによる複数送信・単一受信のロックフリーキュー */
+    class CommandBus : public ICommandBus
+    {
+    public:
+        // キューの長さ（2のべき乗）
+        static constexpr size_t CAPACITY = 64;
+
+        CommandBus() noexcept;
+        ~CommandBus() noexcept override;
+
+        bool post(const Command& cmd) override;
+        bool poll(Command& cmd) override;
+
+    private:
+        /* キューの要素（seqで書き込み済みかどうかを判定する） */
+        struct Cell
+        {
+            std::atomic<size_t> seq;
+            Command cmd;
+        };
+
+        std::array<Cell, CAPACITY> cells_;
+
+        // 送信側が奪い合う書き込み位置と、受信側だけが使う読み出し位置は別のキャッシュラインに置く
+        alignas(64) std::atomic<size_t> tail_;
+        alignas(64) size_t head_;
+    };
+
+}
+
+#endif
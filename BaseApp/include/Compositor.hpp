@@ -0,0 +1,88 @@
+/**
+ * @file    Compositor.hpp
+ * @brief   Viewport surface composition
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#ifndef __COMPOSITOR_HPP__
+#define __COMPOSITOR_HPP__
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "PanelManager.hpp"
+
+namespace tll
+{
+
+    /* パネル上の表示領域 */
+    struct Viewport
+    {
+        int32_t x;
+        int32_t y;
+        uint16_t w;
+        uint16_t h;
+    };
+
+    /* 各ビューポートの画面外バッファをパネルに合成するクラス */
+    class Compositor
+    {
+    public:
+        // どのレイヤにも含まれない場合のレイヤID
+        static constexpr uint16_t NONE = 0;
+
+        Compositor() noexcept {}
+
+        // ビューポートを持つレイヤを追加し、レイヤIDを返す（後から追加したレイヤが上に重なる、追加できない場合はNONE）
+        uint16_t addLayer(const Viewport& viewport);
+
+        // レイヤを削除し、バッファを解放する（描画スレッドの終了後に呼ぶ）
+        void removeLayer(uint16_t id);
+
+        // 描画用のバッファを取得する（描画スレッドから呼ぶ）
+        Surface* beginDraw(uint16_t id);
+
+        // 描画し終えたバッファを合成対象にする
+        void endDraw(uint16_t id);
+
+        // 各レイヤの描画済みの最新のバッファをパネルに書き込む（描画中のレイヤは待たない）
+        void compose();
+
+        // 指定座標を含む最も上のレイヤIDを返す
+        uint16_t hitTest(int32_t x, int32_t y);
+
+        // レイヤのビューポートを取得する
+        Viewport getViewport(uint16_t id);
+
+    private:
+        /* 表示領域ごとの二重バッファ */
+        struct Layer
+        {
+            bool has_frame;    // 合成できる描画済みのバッファがあるか
+
+            Viewport viewport;
+
+            Surface front;     // 合成に使う描画済みのバッファ
+            Surface back;      // 描画スレッドが書き込むバッファ
+
+            std::mutex mutex;  // frontの入れ替え・読み出し用
+        };
+
+        Layer* find(uint16_t id);
+
+        // 削除されたレイヤはnullptrにし、IDを再利用する
+        std::vector<std::unique_ptr<Layer>> layers_;
+        std::vector<uint16_t> free_ids_;
+
+        // 追加された順のレイヤID（後ろほど上に重なる）
+        std::vector<uint16_t> order_;
+
+        std::mutex mutex_;
+    };
+
+}
+
+#endif
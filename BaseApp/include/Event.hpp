@@ -10,6 +10,7 @@
 
 #include "TLL.h"
 
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <vector>
@@ -17,6 +18,8 @@
 #include <map>
 #include <mutex>
 
+#include <termios.h>
+
 #include "tllEngine.hpp"
 
 #include "TuioServer.h"
@@ -73,9 +76,40 @@ namespace tll
         // 終了フラグを更新｀
         void setQuitFlag(bool new_flag) { quit_flag_ = new_flag; }
 
+        // 受信・送出したイベント数を取得
+        EventStats getStats() noexcept { return EventStats{ osc_received_.load(), tuio_sent_.load(), dropped_.load() }; }
+
+        // OSCでイベントを受信した際に計上する
+        void countReceived() noexcept { osc_received_++; }
+
+        // 不正なメッセージやキューの溢れでイベントを捨てた際に計上する
+        void countDropped() noexcept { dropped_++; }
+
+        // タッチ状態を更新する間に保持する（OSC受信スレッド・IRスレッド・メインループから呼ばれるため）
+        std::mutex& getEventMutex() noexcept { return event_mutex_; }
+
+        // 入力を持たない子プロセスで、親から共有されたタッチ点の数をgetTouchedNumで返すようにする
+        void mirrorTouchedNum(const std::atomic<uint32_t>* source) noexcept { touched_num_source_ = source; }
+
+    protected:
+        /// Number of events sent to TUIO
+        std::atomic<uint64_t> tuio_sent_{0};
+
+        /// Touch count shared by the parent process (nullptr when this process owns the input)
+        const std::atomic<uint32_t>* touched_num_source_ = nullptr;
+
     private:
         /// Quit flag
         bool quit_flag_ = false;
+
+        /// Number of events received via OSC
+        std::atomic<uint64_t> osc_received_{0};
+
+        /// Number of events discarded before reaching an app
+        std::atomic<uint64_t> dropped_{0};
+
+        /// Guards the touch state and the TUIO server
+        std::mutex event_mutex_;
     };
 
     /* タッチイベント管理クラス（TUIO使用） */
@@ -113,8 +147,21 @@ namespace tll
         uint32_t getTouchedNum() override;
 
     private:
-        // キーボード入力処理
-        int kbhit();
+        // 標準入力をepollで待ち受け、押されたキーをメインループに渡す
+        void threadKeyInput();
+
+        // 標準入力の元の端末設定（終了時に戻す）
+        struct termios orig_termios_;
+        bool raw_mode_ = false;
+
+        // キー入力スレッドの停止通知用eventfd
+        int wake_fd_ = -1;
+        std::thread key_thread_;
+
+        // キー入力スレッドから受け取った未処理のキー
+        std::vector<int> key_queue_;
+        std::mutex key_mutex_;
+        std::atomic<bool> key_pending_{false};
 
         // OscSender
         TUIO::OscSender* sender_;
@@ -142,12 +189,10 @@ namespace tll
     private:
         // 受信したOSCメッセージをスラッシュごとに区切ったリストに分割する
         std::vector<std::string> split(const std::string msg);
-
-        std::mutex osc_mutex_;
     };
 
-    // タッチイベント関連のOSCメッセージをスレッドで受信し始める
-    void threadListen();
+    // タッチイベント関連のOSCメッセージをUdpReactorで受信し始める
+    void listenTouchEvents();
 }
 
 #endif
@@ -0,0 +1,110 @@
+/**
+ * @file    FrameWatchdog.hpp
+ * @brief   Per-app frame budget watchdog
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#ifndef __FRAME_WATCHDOG_HPP__
+#define __FRAME_WATCHDOG_HPP__
+
+#include <chrono>
+#include <cstdint>
+
+namespace tll
+{
+
+    /* アプリのrun()から参照できるフレームの情報 */
+    struct FrameContext
+    {
+        // 品質レベルの最大値（処理落ちが続くと下がり、余裕ができると戻る）
+        static constexpr uint8_t QUALITY_MAX = 3;
+
+        uint64_t frame = 0;             // フレーム番号
+        uint32_t budget_us = 0;         // run()に使える時間（0: 監視されていない）
+        uint32_t last_us = 0;           // 前回のrun()にかかった時間
+        uint32_t dropped_frames = 0;    // 予算を超えたフレーム数（起動からの累計）
+        uint8_t quality = QUALITY_MAX;  // 品質レベル（0: 最低）
+
+        // 監視されていないホスト（ビューポートや子プロセス）では期限無しとし、品質を下げさせない
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+
+        // 予算の残り時間[us]（超過している場合は負の値）
+        int64_t budgetLeftUs() const
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(this->deadline - std::chrono::steady_clock::now()).count();
+        }
+    };
+
+    /* フレーム予算の監視用のパラメータ */
+    struct BudgetConfig
+    {
+        // run()に使える時間[us]
+        uint32_t budget_us = 16000;
+
+        // 品質を下げるまでの連続超過フレーム数
+        uint32_t degrade_frames = 5;
+
+        // 品質を戻すまでの、予算の半分以内で終わった連続フレーム数
+        uint32_t restore_frames = 90;
+
+        // 品質が最低でも超過が続く場合に、run()を呼ぶ間隔の最大値（1で間引かない）
+        uint32_t max_throttle = 4;
+
+        // 最大まで間引いても超過が続く場合に、アプリを降格させるまでの連続超過フレーム数（0で降格させない）
+        uint32_t demote_frames = 150;
+    };
+
+    /* 監視結果として必要な対応 */
+    enum class EBudgetAction : uint8_t
+    {
+        NONE,
+        DEGRADE,     // 品質を下げた
+        RESTORE,     // 品質を戻した
+        THROTTLE,    // run()の間隔を広げた
+        DEMOTE,      // アプリを降格させる必要がある
+    };
+
+    /* アプリのrun()にかかる時間をフレーム予算と比較し、品質・実行間隔を調整するクラス */
+    class FrameWatchdog
+    {
+    public:
+        FrameWatchdog() noexcept;
+        FrameWatchdog(BudgetConfig config) noexcept;
+
+        // アプリの切り替え時に状態を初期化する
+        void reset();
+
+        // フレームの開始時に呼び、このフレームでrun()を呼ぶか返す（間引き中はfalse）
+        bool begin(FrameContext& ctx);
+
+        // run()の終了時に呼び、かかった時間から必要な対応を返す
+        EBudgetAction end(FrameContext& ctx);
+
+        // run()を呼ぶ間隔（1: 毎フレーム）
+        uint32_t getThrottle() const noexcept { return this->throttle_; }
+
+        BudgetConfig& getConfig() noexcept { return this->config_; }
+
+    private:
+        // 連続超過・余裕のあるフレーム数から品質・実行間隔を更新する
+        EBudgetAction update();
+
+        BudgetConfig config_;
+
+        uint64_t frame_;
+        uint32_t dropped_frames_;
+        uint32_t last_us_;
+        uint8_t quality_;
+        uint32_t throttle_;
+
+        // 連続して予算を超えた・余裕があったフレーム数
+        uint32_t over_streak_;
+        uint32_t under_streak_;
+
+        std::chrono::steady_clock::time_point start_tp_;
+    };
+
+}
+
+#endif
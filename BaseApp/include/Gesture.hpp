@@ -0,0 +1,147 @@
+/**
+ * @file    Gesture.hpp
+ * @brief   Gesture recognition
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#ifndef __GESTURE_HPP__
+#define __GESTURE_HPP__
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+#include "TouchInfo.hpp"
+
+namespace tll
+{
+
+    /* ジェスチャ判定用のパラメータ */
+    struct GestureConfig
+    {
+        // タップとみなす最大押下時間[ms]
+        uint32_t tap_time = 250;
+
+        // ダブルタップとみなす最大間隔[ms]
+        uint32_t double_tap_interval = 300;
+
+        // 長押しとみなす押下時間[ms]
+        uint32_t long_press_time = 600;
+
+        // 複数点ホールドとみなす押下時間[ms]
+        uint32_t hold_time = 1000;
+
+        // スワイプとみなす最大時間[ms]
+        uint32_t swipe_time = 500;
+
+        // 静止とみなす移動量[px]
+        int32_t slop = 2;
+
+        // スワイプとみなす最小移動量[px]
+        int32_t swipe_distance = 8;
+    };
+
+    /* タッチイベント列からジェスチャを判定するクラス */
+    class GestureRecognizer
+    {
+    public:
+        // 同時に追跡するタッチ点の最大数
+        static constexpr uint32_t MAX_TOUCHES = 16;
+
+        // 未処理のまま保持できるジェスチャの最大数
+        static constexpr uint32_t MAX_PENDING = 32;
+
+        GestureRecognizer() noexcept;
+        GestureRecognizer(GestureConfig config) noexcept;
+
+        // タッチ点が追加された際の処理
+        void touch(const TouchInfo& ti);
+
+        // タッチ点が移動した際の処理
+        void move(const TouchInfo& ti);
+
+        // タッチ点が削除された際の処理
+        void release(const TouchInfo& ti);
+
+        // 時間経過で成立するジェスチャ（長押し・ホールド）を判定する
+        void update();
+
+        // 全タッチ点の状態を破棄する
+        void reset();
+
+        // 指定本数のタッチ点が置かれたまま経過した時間[ms]（本数が異なる場合は0）
+        uint32_t getHoldDuration(uint32_t fingers);
+
+        // 判定済みのジェスチャを1件取り出す（無ければfalse）
+        bool poll(GestureInfo& gi);
+
+        GestureConfig& getConfig() noexcept { return this->config_; }
+
+    private:
+        using TimePoint = std::chrono::steady_clock::time_point;
+
+        /* タッチ点ごとの状態 */
+        struct TouchState
+        {
+            bool active = false;
+            bool moved  = false;
+            bool long_pressed = false;
+
+            // 複数点ジェスチャに関わった点は単独ジェスチャとして判定しない
+            bool multi = false;
+
+            uint32_t id = 0;
+
+            int32_t start_x = 0;
+            int32_t start_y = 0;
+            int32_t x = 0;
+            int32_t y = 0;
+
+            TimePoint start_time;
+        };
+
+        TouchState* find(uint32_t id);
+        TouchState* allocate(uint32_t id);
+
+        // 2点の距離・角度をピンチの基準として記録する
+        void beginPinch();
+
+        // 判定したジェスチャを待ち行列に積む
+        void emit(const GestureInfo& gi);
+
+        static uint32_t elapsed(TimePoint from, TimePoint to);
+
+        GestureConfig config_;
+
+        std::array<TouchState, MAX_TOUCHES> touches_;
+        uint32_t active_num_;
+
+        // ダブルタップ判定用の直前のタップ
+        bool has_last_tap_;
+        int32_t last_tap_x_;
+        int32_t last_tap_y_;
+        TimePoint last_tap_time_;
+
+        // 複数点ホールド判定用
+        bool hold_fired_;
+        TimePoint hold_start_time_;
+
+        // ピンチ判定用の基準値
+        bool pinching_;
+        float pinch_distance_;
+        float pinch_angle_;
+        TimePoint pinch_start_time_;
+
+        // 判定済みジェスチャのリングバッファ
+        std::array<GestureInfo, MAX_PENDING> pending_;
+        uint32_t pending_head_;
+        uint32_t pending_num_;
+
+        std::mutex mutex_;
+    };
+
+}
+
+#endif
@@ -0,0 +1,110 @@
+/**
+ * @file    HitTester.hpp
+ * @brief   Touch region hit testing
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#ifndef __HIT_TESTER_HPP__
+#define __HIT_TESTER_HPP__
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "TouchInfo.hpp"
+
+namespace tll
+{
+
+    /* タッチイベントの種類 */
+    enum class ETouchEvent : uint8_t
+    {
+        TOUCHED,
+        MOVED,
+        RELEASED,
+    };
+
+    /* 登録したタッチ領域をパネル上のピクセル単位の索引で判定するクラス */
+    class HitTester
+    {
+    public:
+        // 領域に対応するイベント処理
+        using Handler = std::function<void(ETouchEvent event, const TouchInfo& ti)>;
+
+        // どの領域にも含まれない場合の領域ID
+        static constexpr uint16_t NONE = 0;
+
+        HitTester() noexcept;
+
+        // パネルサイズで索引を初期化する
+        void init(uint16_t width, uint16_t height);
+
+        // 矩形領域を登録し、領域IDを返す（後から登録した領域が優先される、登録できない場合はNONE）
+        // 解除された領域のIDは再利用される
+        uint16_t addRect(int32_t x, int32_t y, int32_t w, int32_t h, Handler handler = nullptr);
+
+        // 円形領域を登録し、領域IDを返す
+        uint16_t addCircle(int32_t x, int32_t y, int32_t rad, Handler handler = nullptr);
+
+        // 領域の登録を解除する
+        void remove(uint16_t id);
+
+        // 全領域の登録を解除する
+        void clear();
+
+        // 指定座標の領域IDを返す
+        uint16_t hitTest(int32_t x, int32_t y);
+
+        // タッチ座標の領域に登録されたイベント処理を呼び出す（呼び出した場合はtrue）
+        // TOUCHEDで触れた領域が、離すまでそのタッチ点の移動・解放を受け取る
+        bool dispatch(ETouchEvent event, const TouchInfo& ti);
+
+    private:
+        /* 登録された領域 */
+        struct Region
+        {
+            bool active;
+            bool circle;
+
+            int32_t x;
+            int32_t y;
+            int32_t w;    // 円の場合は半径
+            int32_t h;
+
+            Handler handler;
+        };
+
+        // 空いている領域IDに登録する
+        uint16_t add(const Region& r);
+
+        // 領域を索引に書き込む
+        void rasterize(uint16_t id, const Region& r);
+
+        // 全領域から索引を作り直す
+        void rebuild();
+
+        uint16_t width_;
+        uint16_t height_;
+
+        // 領域リスト（領域ID - 1 が添字）と、解除されて再利用できる領域ID
+        std::vector<Region> regions_;
+        std::vector<uint16_t> free_ids_;
+
+        // 登録順の領域ID（索引を作り直す際は後のものほど前面になる）
+        std::vector<uint16_t> order_;
+
+        // タッチ点ID -> TOUCHEDで触れた領域ID
+        std::unordered_map<uint32_t, uint16_t> captured_;
+
+        // ピクセルごとの最前面の領域ID
+        std::vector<uint16_t> index_;
+
+        std::mutex mutex_;
+    };
+
+}
+
+#endif
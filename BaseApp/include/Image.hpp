@@ -9,6 +9,7 @@
 #define __IMAGE_HPP__
 
 #include "Color.hpp"
+#include "PanelManager.hpp"
 
 #include <opencv2/opencv.hpp>
 
@@ -21,18 +22,36 @@ namespace tll
         Image() noexcept;
         Image(cv::Mat img_data) noexcept;
 
-        // 指定座標に画像を表示
-        void draw(uint32_t x, uint32_t y);
+        // 指定座標に画像を表示（パネルからはみ出す部分は切り取る）
+        void draw(uint32_t x, uint32_t y) const;
 
         // 指定座標に色を付けて画像を表示
-        void draw(uint32_t x, uint32_t y, tll::Color color);
+        void draw(uint32_t x, uint32_t y, tll::Color color) const;
+
+        // 指定座標に画像の色の付いたピクセルだけを表示（黒のピクセルは背景を残す）
+        void drawTransparent(uint32_t x, uint32_t y) const;
+
+        // 指定座標に画像の色の付いたピクセルだけを指定色で表示
+        void drawTransparent(uint32_t x, uint32_t y, tll::Color color) const;
 
         // 指定サイズにリサイズ
         void resize(uint32_t height, uint32_t width);
 
+        uint16_t getWidth()  const noexcept { return this->surface_.width;  }
+        uint16_t getHeight() const noexcept { return this->surface_.height; }
+
     private:
-        // 画像データ（OpenCVの形式を利用）
+        // 画像データをパネルと同じ形式に変換する
+        void convert();
+
+        // 画像データ（OpenCVの形式を利用、リサイズ時に使う）
         cv::Mat img_data_;
+
+        // パネルと同じ形式（RGB）に変換した画素
+        Surface surface_;
+
+        // 色の付いたピクセルのマスク（色付き・透過描画用）
+        Mask mask_;
     };
 }
 
@@ -0,0 +1,124 @@
+/**
+ * @file    LatencyTracer.hpp
+ * @brief   Touch-to-photon latency tracing
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#ifndef __LATENCY_TRACER_HPP__
+#define __LATENCY_TRACER_HPP__
+
+#include "TLL.h"
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+
+namespace tll
+{
+
+    /* タッチイベントが通過する処理段階 */
+    enum class ETraceStage : uint8_t
+    {
+        OSC_RECEIVED,       // OscReceiverで受信
+        TUIO_SENT,          // EventHandlerTuioがTUIOで送出
+        TUIO_RECEIVED,      // BaseAppがTUIOで受信
+        APP_HANDLED,        // アプリのコールバックが完了
+        FRAME_PUBLISHED,    // その後の最初のフレームを送信
+        NUM,
+    };
+
+    /* 対数目盛りのレイテンシ分布（1オクターブを4分割） */
+    class LatencyHistogram
+    {
+    public:
+        void add(uint32_t us) noexcept;
+
+        // 指定パーセンタイルを含む区間の上限値[us]を返す
+        uint32_t percentile(double p) const noexcept;
+
+        uint64_t getCount() const noexcept { return this->count_; }
+
+    private:
+        static uint32_t toBucket(uint32_t us) noexcept;
+        static uint32_t upperBound(uint32_t bucket) noexcept;
+
+        std::array<uint64_t, 128> buckets_{};
+        uint64_t count_ = 0;
+    };
+
+    /* レイテンシ計測インターフェースクラス */
+    class ILatencyTracer
+    {
+    public:
+        virtual ~ILatencyTracer() = default;
+
+        // インスタンスを作成
+        static ILatencyTracer* create();
+
+        // OSCでタッチイベントを受信した時点でトレースを開始する
+        virtual uint64_t begin(uint32_t touch_id) = 0;
+
+        // タッチ点のトレースが指定段階を通過したことを記録する
+        virtual void mark(uint32_t touch_id, ETraceStage stage) = 0;
+
+        // 進行中のトレースIDと開始時刻[us]を取得する（無ければfalse）
+        virtual bool lookup(uint32_t touch_id, uint64_t& trace_id, uint64_t& timestamp) = 0;
+
+        // フレームの送信データ作成開始時に呼ぶ
+        virtual void beginFrame() = 0;
+
+        // フレームの送信完了時に呼ぶ
+        virtual void endFrame() = 0;
+
+        // 段階ごとのレイテンシ統計を取得
+        virtual LatencyStats getStats() = 0;
+
+        // 単調増加する現在時刻[us]
+        static uint64_t now() noexcept;
+    };
+
+    /* レイテンシ計測クラス */
+    class LatencyTracer : public ILatencyTracer
+    {
+    public:
+        // 同時に追跡するタッチ点の最大数
+        static constexpr uint32_t MAX_TRACES = 16;
+
+        LatencyTracer() noexcept;
+        ~LatencyTracer() noexcept override;
+
+        uint64_t begin(uint32_t touch_id) override;
+        void mark(uint32_t touch_id, ETraceStage stage) override;
+        bool lookup(uint32_t touch_id, uint64_t& trace_id, uint64_t& timestamp) override;
+        void beginFrame() override;
+        void endFrame() override;
+        LatencyStats getStats() override;
+
+    private:
+        /* タッチ点ごとの進行中のトレース */
+        struct Trace
+        {
+            bool active = false;
+            bool in_frame = false;
+
+            uint32_t touch_id = 0;
+            uint64_t trace_id = 0;
+
+            std::array<uint64_t, static_cast<size_t>(ETraceStage::NUM)> time{};
+        };
+
+        Trace* find(uint32_t touch_id);
+
+        std::array<Trace, MAX_TRACES> traces_;
+        uint64_t next_trace_id_;
+
+        // 隣接する段階間、および全体のレイテンシ分布
+        std::array<LatencyHistogram, static_cast<size_t>(ETraceStage::NUM)> histograms_;
+
+        std::mutex mutex_;
+    };
+
+}
+
+#endif
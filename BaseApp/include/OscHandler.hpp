@@ -15,6 +15,8 @@
 #include "osc/OscPacketListener.h"
 #include "osc/OscOutboundPacketStream.h"
 
+#include "OscRouter.hpp"
+
 namespace tll
 {
 
@@ -22,11 +24,11 @@ namespace tll
     class OscHandler : public osc::OscPacketListener
     {
     public:
-        OscHandler() noexcept {}
-        OscHandler(class BaseApp* base_app) noexcept :app_ref(base_app) {}
+        OscHandler() noexcept :app_ref(nullptr) {}
+        OscHandler(class BaseApp* base_app) noexcept;
         ~OscHandler() noexcept {}
 
-        // OSCメッセージを送信する
+        // OSCメッセージを送信待ちに追加する（フレームの終わりにまとめて送信される）
         static void sendMessage(const char* address, const char* dst_ip = "127.0.0.1", int port = 7000);
 
         // int型の引数付きでOSCメッセージを送信する
@@ -38,15 +40,21 @@ namespace tll
         // string型の引数付きでOSCメッセージを送信する
         static void sendMessageWithString(const char* address, std::string value, const char* dst_ip = "127.0.0.1", int port = 7000);
 
+        // 送信待ちのメッセージを送信先ごとに1つのバンドルにまとめて送る（syncがfalseの場合は送信スレッドで送る）
+        static void flush(bool sync = false);
+
     protected:
         // 受信したOSCメッセージを解析する
         virtual void ProcessMessage(const osc::ReceivedMessage& msg, const IpEndpointName& remote_end_pt) override;
 
         class BaseApp* app_ref;
+
+        // システム用のルート
+        OscRouter routes_;
     };
 
-    // OSCメッセージ受信スレッドの起動
-    void runOscReceiveThread(class BaseApp* base_app);
+    // OSCメッセージをUdpReactorで受信し始める
+    void startOscReceive(class BaseApp* base_app);
 }
 
 #endif
@@ -0,0 +1,124 @@
+/**
+ * @file    OscRouter.hpp
+ * @brief   OSC address pattern routing
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#ifndef __OSC_ROUTER_HPP__
+#define __OSC_ROUTER_HPP__
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "osc/OscReceivedElements.h"
+
+namespace tll
+{
+
+    /* 登録時にアドレスパターンを解析しておき、受信メッセージを対応するハンドラに配送するクラス */
+    class OscRouter
+    {
+    public:
+        // メッセージに対応する処理
+        using Handler = std::function<void(const osc::ReceivedMessage& msg)>;
+
+        // 無効なルートID
+        static constexpr uint16_t NONE = 0;
+
+        OscRouter() noexcept {}
+
+        // 1つのメッセージで呼び出せるハンドラの上限
+        static constexpr size_t MAX_MATCHES = 64;
+
+        // アドレスパターンにハンドラを登録し、ルートIDを返す（?, *, [a-z], [!a-z], {a,b} が使える、登録できない場合はNONE）
+        uint16_t route(const std::string& pattern, Handler handler);
+
+        // 第1引数がint型のメッセージを受け取るハンドラを登録する
+        uint16_t routeInt32(const std::string& pattern, std::function<void(int32_t value)> handler);
+
+        // 第1引数がfloat型のメッセージを受け取るハンドラを登録する
+        uint16_t routeFloat(const std::string& pattern, std::function<void(float value)> handler);
+
+        // 第1引数がstring型のメッセージを受け取るハンドラを登録する
+        uint16_t routeString(const std::string& pattern, std::function<void(const char* value)> handler);
+
+        // ルートの登録を解除する
+        void remove(uint16_t id);
+
+        // 全ルートの登録を解除する
+        void clear();
+
+        // 登録されたルートが無いかどうか
+        bool empty();
+
+        // 一致する全てのルートのハンドラを呼び出す（一致しなかった場合はfalse）
+        bool dispatch(const osc::ReceivedMessage& msg);
+
+    private:
+        /* パターンの構成要素の種類 */
+        enum class EToken : uint8_t
+        {
+            LITERAL,         // 文字列
+            ANY_CHAR,        // ?
+            ANY_STRING,      // *
+            CHAR_SET,        // [...]
+            ALTERNATIVES,    // {...,...}
+        };
+
+        /* パターンの構成要素 */
+        struct Token
+        {
+            EToken type;
+            bool negate;                      // [!...] の場合にtrue
+            std::string chars;                // 文字列、または文字集合（範囲は展開済み）
+            std::vector<std::string> words;   // {...} の候補
+        };
+
+        // '/' で区切られた1階層分の構成要素
+        using Segment = std::vector<Token>;
+
+        /* 登録されたルート */
+        struct Route
+        {
+            bool active;
+            bool wildcard;
+            uint32_t serial;    // IDが再利用されたことを見分けるための登録番号
+
+            std::string pattern;
+            std::vector<Segment> segments;
+
+            // 呼び出し中に解除されても解放されないよう共有で持つ
+            std::shared_ptr<const Handler> handler;
+        };
+
+        // パターンを階層ごとの構成要素に分解する
+        static std::vector<Segment> compile(const std::string& pattern);
+
+        // 1階層分の文字列が構成要素の並びに一致するかどうか
+        static bool matchSegment(const Segment& segment, size_t token, const char* str, size_t len);
+
+        // アドレス全体がルートに一致するかどうか
+        static bool match(const Route& route, const char* address);
+
+        std::vector<Route> routes_;
+
+        // 解除されたルートのID（次の登録で再利用する）
+        std::vector<uint16_t> free_ids_;
+        uint32_t serial_ = 0;
+
+        // ワイルドカードを含まないルートはアドレスのハッシュで引く
+        std::unordered_multimap<size_t, uint16_t> exact_;
+        std::vector<uint16_t> wildcards_;
+
+        std::mutex mutex_;
+    };
+
+}
+
+#endif
@@ -18,6 +18,74 @@
 namespace tll
 {
 
+    /* 画面外バッファの参照（画素を所有しない） */
+    struct SurfaceView
+    {
+        uint16_t width;
+        uint16_t height;
+        const Color* pixels;
+    };
+
+    /* マスクの参照（ビットを所有しない） */
+    struct MaskView
+    {
+        uint16_t width;
+        uint16_t height;
+        uint16_t words;    // 1行あたりのワード数
+        const uint64_t* bits;
+
+        const uint64_t* row(uint16_t y) const noexcept { return this->bits + y * this->words; }
+    };
+
+    /* パネルと同じ形式の画面外バッファ */
+    struct Surface
+    {
+        uint16_t width = 0;
+        uint16_t height = 0;
+        std::vector<Color> pixels;
+
+        void resize(uint16_t w, uint16_t h)
+        {
+            this->width  = w;
+            this->height = h;
+            this->pixels.assign(w * h, Color());
+        }
+
+        operator SurfaceView() const noexcept { return SurfaceView{ this->width, this->height, this->pixels.data() }; }
+    };
+
+    /* 画面外バッファの色の付いたピクセルを1ビットで表したマスク（行ごとに64ビット単位で詰める） */
+    struct Mask
+    {
+        uint16_t width = 0;
+        uint16_t height = 0;
+        uint16_t words = 0;    // 1行あたりのワード数
+        std::vector<uint64_t> bits;
+
+        // 黒以外のピクセルを1とするマスクを作成する
+        void build(const Surface& surface)
+        {
+            this->width  = surface.width;
+            this->height = surface.height;
+            this->words  = (surface.width + 63) / 64;
+            this->bits.assign(this->words * surface.height, 0);
+
+            for (uint16_t y = 0; y < surface.height; y++)
+            {
+                const Color* src = &surface.pixels[y * surface.width];
+                uint64_t* row = &this->bits[y * this->words];
+
+                for (uint16_t x = 0; x < surface.width; x++)
+                {
+                    if ((src[x].r_ | src[x].g_ | src[x].b_) != 0)
+                        row[x >> 6] |= uint64_t(1) << (x & 63);
+                }
+            }
+        }
+
+        operator MaskView() const noexcept { return MaskView{ this->width, this->height, this->words, this->bits.data() }; }
+    };
+
     /* LEDパネルの状態管理インターフェースクラス */
     class IPanelManager
     {
@@ -45,14 +113,31 @@ namespace tll
         // 全ピクセルを黒で塗りつぶす
         virtual void clear() = 0;
 
-        uint16_t getWidth()  noexcept { return width_;  }
-        uint16_t getHeight() noexcept { return height_; }
+        // 画面外バッファをパネルの指定位置に書き込む（描画先の切り替えに関わらずパネルに書き込む）
+        virtual void blit(int32_t x, int32_t y, const Surface& surface) = 0;
+
+        // 画面外バッファを描画先の指定位置に書き込む
+        virtual void drawSurface(int32_t x, int32_t y, const SurfaceView& surface) = 0;
+
+        // マスクが1のピクセルだけ画面外バッファを描画先に書き込む
+        virtual void drawSurfaceMasked(int32_t x, int32_t y, const SurfaceView& surface, const MaskView& mask) = 0;
+
+        // マスクが1のピクセルを指定色で塗る（transparentがfalseの場合は0のピクセルを黒で塗る）
+        virtual void drawMask(int32_t x, int32_t y, const MaskView& mask, Color color, bool transparent) = 0;
+
+        // 呼び出したスレッドの描画先を画面外バッファに切り替える（nullptrでパネルに戻す）
+        static void setRenderTarget(Surface* surface) noexcept { render_target_ = surface; }
+        static Surface* getRenderTarget() noexcept { return render_target_; }
+
+        // 描画先の幅・高さ
+        uint16_t getWidth()  noexcept { return render_target_ ? render_target_->width  : width_;  }
+        uint16_t getHeight() noexcept { return render_target_ ? render_target_->height : height_; }
 
         void setWidth(uint16_t width)   noexcept { this->width_ = width;   }
         void setHeight(uint16_t height) noexcept { this->height_ = height; }
 
         // ピクセル数を取得する
-        uint16_t getPixelsNum() noexcept { return width_ * height_; }
+        uint16_t getPixelsNum() noexcept { return getWidth() * getHeight(); }
 
         // 特定座標の現在の色を取得する
         Color getColor(int x, int y)
@@ -61,7 +146,10 @@ namespace tll
 
             try
             {
-                color = this->color_.at(y * width_ + x);
+                if (render_target_)
+                    color = render_target_->pixels.at(y * render_target_->width + x);
+                else
+                    color = this->color_.at(y * width_ + x);
             }
             catch (std::out_of_range& e)
             {
@@ -72,6 +160,9 @@ namespace tll
         }
 
     protected:
+        /// Off-screen surface drawn by the calling thread (nullptr: panel)
+        static thread_local Surface* render_target_;
+
         /// Color infomation for each pixel
         std::vector<Color> color_;
 
@@ -106,6 +197,22 @@ namespace tll
 
         // 全ピクセルを黒で塗りつぶす
         void clear() noexcept override;
+
+        // 画面外バッファをパネルの指定位置に書き込む
+        void blit(int32_t x, int32_t y, const Surface& surface) noexcept override;
+
+        // 画面外バッファを描画先の指定位置に書き込む
+        void drawSurface(int32_t x, int32_t y, const SurfaceView& surface) noexcept override;
+
+        // マスクが1のピクセルだけ画面外バッファを描画先に書き込む
+        void drawSurfaceMasked(int32_t x, int32_t y, const SurfaceView& surface, const MaskView& mask) noexcept override;
+
+        // マスクが1のピクセルを指定色で塗る
+        void drawMask(int32_t x, int32_t y, const MaskView& mask, Color color, bool transparent) noexcept override;
+
+    private:
+        // 呼び出したスレッドの描画先の先頭ピクセルと大きさを取得する
+        Color* target(uint16_t& width, uint16_t& height) noexcept;
     };
 
 }
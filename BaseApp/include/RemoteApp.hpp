@@ -0,0 +1,146 @@
+/**
+ * @file    RemoteApp.hpp
+ * @brief   Out-of-process app hosting over shared memory
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#ifndef __REMOTE_APP_HPP__
+#define __REMOTE_APP_HPP__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include <sys/types.h>
+
+#include "AppInterface.hpp"
+#include "PanelManager.hpp"
+
+namespace tll
+{
+
+    namespace remote
+    {
+        // 共有メモリの識別子（"TLL1"）
+        constexpr uint32_t MAGIC = 0x544C4C31;
+
+        // イベントリングの長さ（2のべき乗）
+        constexpr uint32_t RING_SIZE = 256;
+
+        // 三重バッファの番号と、新しいフレームがあることを示すフラグ
+        constexpr uint32_t INDEX_MASK = 0x3;
+        constexpr uint32_t NEW_FRAME  = 0x4;
+
+        /* 子プロセスに送るイベントの種類 */
+        enum class EEvent : uint8_t
+        {
+            TOUCHED,
+            MOVED,
+            RELEASED,
+            BLOB_ADDED,
+            BLOB_MOVED,
+            BLOB_REMOVED,
+            GESTURE,
+        };
+
+        /* 子プロセスに送るイベント */
+        struct Event
+        {
+            EEvent type;
+            TouchInfo ti;
+            GestureInfo gi;
+
+            // BlobInfoは代入演算子が値を書き換えないため、値を個別に持つ
+            uint32_t blob_id;
+            int32_t blob_x;
+            int32_t blob_y;
+            int32_t blob_w;
+            int32_t blob_h;
+        };
+
+        /* 親子プロセスで共有する領域（この後に3枚分のピクセルが続く） */
+        struct SharedFrame
+        {
+            uint32_t magic;
+            uint16_t width;
+            uint16_t height;
+
+            std::atomic<uint32_t> stop;      // 親から子への終了要求
+            std::atomic<uint32_t> latest;    // 最新の描画済みバッファ番号 | NEW_FRAME
+            std::atomic<uint64_t> frames;    // 子が描画し終えたフレーム数
+            std::atomic<uint32_t> touched_num; // 親が毎フレーム書き込むタッチ点の数
+
+            // 親が書き込み、子が読み出すイベントのリング
+            std::atomic<uint32_t> ring_head;
+            std::atomic<uint32_t> ring_tail;
+            Event ring[RING_SIZE];
+        };
+
+        // 共有領域全体の大きさ
+        size_t sharedSize(uint16_t width, uint16_t height);
+
+        // 指定番号のバッファの先頭ピクセル
+        Color* pixels(SharedFrame* shared, uint32_t index);
+    }
+
+    /* アプリを子プロセスで動かし、共有メモリ経由で描画結果とイベントをやり取りする代理アプリ */
+    class RemoteApp : public AppInterface
+    {
+    public:
+        RemoteApp(std::string app_path, std::string symbol = "create") noexcept;
+        ~RemoteApp() override;
+
+        // 描画先の大きさの共有メモリを作成し、子プロセスを起動する
+        void init() override;
+
+        // 子プロセスが描画し終えた最新のフレームを描画先に書き込み、次のフレームの描画を促す（完了を待たない）
+        void run() override;
+
+        // 子プロセスを終了させる
+        void terminate() override;
+
+        void onTouched(TouchInfo ti) override;
+        void onMoved(TouchInfo ti) override;
+        void onReleased(TouchInfo ti) override;
+        void onGesture(GestureInfo gi) override;
+
+        void addBlob(BlobInfo bi) override;
+        void moveBlob(BlobInfo bi) override;
+        void removeBlob(BlobInfo bi) override;
+
+    private:
+        // イベントをリングに追加する（一杯の場合は捨てる）
+        void push(remote::Event ev);
+
+        // 領域イベントを作成する
+        static remote::Event makeBlobEvent(remote::EEvent type, const BlobInfo& bi);
+
+        std::string app_path_;
+        std::string symbol_;    // ファクトリ関数名
+        std::string shm_name_;
+
+        remote::SharedFrame* shared_;
+        size_t shared_size_;
+
+        int event_fd_;     // 子プロセスにフレームの開始を知らせる
+        int parent_fd_;    // 子プロセスが親の生存を監視するパイプの書き込み側（書き込まず、閉じると終了を知らせる）
+        pid_t pid_;
+        bool exited_;
+
+        // 親が読み出しに使うバッファ番号と、最後に読み出したフレーム
+        uint32_t read_index_;
+        Surface frame_;
+
+        // タッチ・ジェスチャは別スレッドから届くため、リングへの書き込みを排他する
+        std::mutex push_mutex_;
+    };
+
+    // 子プロセスとしてアプリを動かす（BaseAppの --app-host から呼ばれる）
+    int runAppHost(const char* app_path, const char* symbol, const char* shm_name, int event_fd, int parent_fd);
+
+}
+
+#endif
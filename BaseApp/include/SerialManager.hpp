@@ -8,6 +8,8 @@
 #ifndef __SERIAL_MANAGER_HPP__
 #define __SERIAL_MANAGER_HPP__
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 
 namespace tll
@@ -28,6 +30,10 @@ namespace tll
         // 色情報を送信する
         virtual void sendColorData() = 0;
 
+        // 送信する色の輝度（0〜255）を設定する
+        void setBrightness(uint8_t brightness) noexcept { this->brightness_ = brightness; }
+        uint8_t getBrightness() noexcept { return this->brightness_; }
+
         bool send_ready = true;
 
     protected:
@@ -36,6 +42,9 @@ namespace tll
 
         /// LED driver name
         std::string led_driver_;
+
+        /// Brightness applied to sent color data
+        std::atomic<uint8_t> brightness_{255};
     };
 
     /* 通信関連クラス */
@@ -10,9 +10,11 @@
 
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "AssetPack.hpp"
 #include "Image.hpp"
 #include "Video.hpp"
 
@@ -108,14 +110,32 @@ namespace tll
      */
     tll::Image* loadImage(const char* file);
 
+    /**
+     * @fn      std::shared_ptr<const tll::Image> getImage(const char* file, uint16_t width, uint16_t height)
+     * @brief   Get shared image decoded only once per file and size
+     * @param   file    Image file path
+     * @param   width   Width after resize (0: original size)
+     * @param   height  Height after resize (0: original size)
+     * @return  Shared image data (nullptr if not found)
+     */
+    std::shared_ptr<const tll::Image> getImage(const char* file, uint16_t width = 0, uint16_t height = 0);
+
     /**
      * @fn      tll::Video loadVideo(const char* file)
-     * @brief   Load video file
+     * @brief   Load video file (.tllvid files are memory-mapped instead of decoded)
      * @param   file  Video file path
      * @return  Video class data
      */
     tll::Video loadVideo(const char* file);
 
+    /**
+     * @fn      std::shared_ptr<const tll::AssetPack> loadPack(const char* file)
+     * @brief   Map asset pack (.tllpak) built by TLL_Pack
+     * @param   file  Asset pack file path
+     * @return  Mapped asset pack (nullptr on failure)
+     */
+    std::shared_ptr<const tll::AssetPack> loadPack(const char* file);
+
     /**
      * @fn      std::string timeToString()
      * @brief   Get current time (Hours and minutes)
@@ -128,6 +148,62 @@ namespace tll
      * 
      */
     uint32_t getTouchedNum();
+
+    /**
+     * @brief  Number of touch events handled by the event pipeline
+     */
+    struct EventStats
+    {
+        /// Messages received by OscReceiver on port 9000
+        uint64_t osc_received;
+
+        /// Events sent to TUIO by EventHandlerTuio
+        uint64_t tuio_sent;
+
+        /// Packets and events discarded before reaching an app (truncated, malformed or queue overflow)
+        uint64_t dropped;
+    };
+
+    /**
+     * @fn      EventStats getEventStats()
+     * @brief   Get cumulative event counts
+     * @return  Event counts since init()
+     */
+    EventStats getEventStats();
+
+    /**
+     * @brief  Latency percentiles between two trace stages
+     */
+    struct LatencyStageStats
+    {
+        /// Number of completed traces
+        uint64_t count;
+
+        /// Median latency [us]
+        uint32_t p50;
+
+        /// 99th percentile latency [us]
+        uint32_t p99;
+    };
+
+    /**
+     * @brief  Touch-to-photon latency broken down by stage
+     */
+    struct LatencyStats
+    {
+        LatencyStageStats osc_to_tuio;      ///< OscReceiver -> TUIO commit
+        LatencyStageStats tuio_to_base;     ///< TUIO commit -> BaseApp callback
+        LatencyStageStats base_to_app;      ///< BaseApp callback -> app callback done
+        LatencyStageStats app_to_frame;     ///< App callback done -> next frame published
+        LatencyStageStats total;            ///< OscReceiver -> next frame published
+    };
+
+    /**
+     * @fn      LatencyStats getLatencyStats()
+     * @brief   Get latency percentiles of traced touch events
+     * @return  Per-stage latency statistics since init()
+     */
+    LatencyStats getLatencyStats();
 }
 
 #endif
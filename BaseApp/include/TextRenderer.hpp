@@ -8,9 +8,12 @@
 #ifndef __TEXT_RENDERER_HPP__
 #define __TEXT_RENDERER_HPP__
 
+#include "AssetManager.hpp"
 #include "Color.hpp"
 
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
 
 #include <opencv2/freetype.hpp>
@@ -37,6 +40,9 @@ namespace tll
         // フォントデータを読み込む
         virtual void loadFont(const char* font_file_path = "NotoSansJP-Regular.otf") = 0;
 
+        /// Font shared through asset manager
+        std::shared_ptr<Font> font_;
+
         /// freetype object
         cv::Ptr<cv::freetype::FreeType2> ft2_;
 
@@ -60,6 +66,9 @@ namespace tll
     private:
         // フォントデータを読み込む
         void loadFont(const char* font_file_path = "NotoSansJP-Regular.otf") override;
+
+        // ビューポートのアプリが別スレッドから描画するため、フォント描画を排他する
+        std::mutex mutex_;
     };
 
 }
@@ -10,9 +10,28 @@ namespace tll
     {
     public:
         uint32_t id;
-        int32_t x;
+        int32_t x;    // 予測器が有効な場合は予測座標
         int32_t y;
 
+        // センサから受け取った座標
+        int32_t raw_x = 0;
+        int32_t raw_y = 0;
+
+        // 平滑化した座標
+        float smooth_x = 0.f;
+        float smooth_y = 0.f;
+
+        // 速度[px/s]
+        float vx = 0.f;
+        float vy = 0.f;
+
+        // センサ（TUIO）のフレーム時刻[us]（不明な場合は0）
+        uint64_t frame_time = 0;
+
+        // レイテンシ計測用のトレースIDとOSC受信時刻[us]（計測していない場合は0）
+        uint64_t trace_id = 0;
+        uint64_t timestamp = 0;
+
         bool operator==(const TouchInfo& rhs) const
         {
             return this->id == rhs.id;
@@ -34,6 +53,41 @@ namespace tll
         }
     };
 
+    /* ジェスチャの種類 */
+    enum class EGestureType : uint8_t
+    {
+        TAP,
+        DOUBLE_TAP,
+        LONG_PRESS,
+        SWIPE,
+        PINCH,
+        HOLD,
+    };
+
+    struct GestureInfo
+    {
+    public:
+        EGestureType type;
+
+        // ジェスチャに関わった指の本数
+        uint32_t fingers;
+
+        // ジェスチャの代表座標（開始点、または2点の中点）
+        int32_t x;
+        int32_t y;
+
+        // スワイプの移動量
+        int32_t dx;
+        int32_t dy;
+
+        // ピンチの拡大率・回転角[rad]（2点が置かれた時点が基準）
+        float scale;
+        float rotation;
+
+        // ジェスチャ開始からの経過時間[ms]
+        uint32_t duration;
+    };
+
 }
 
 #endif
@@ -0,0 +1,95 @@
+/**
+ * @file    TouchPredictor.hpp
+ * @brief   Touch position prediction
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#ifndef __TOUCH_PREDICTOR_HPP__
+#define __TOUCH_PREDICTOR_HPP__
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+#include "TouchInfo.hpp"
+
+namespace tll
+{
+
+    /* タッチ位置予測用のパラメータ */
+    struct PredictorConfig
+    {
+        // 予測を有効にするか（無効時は座標をそのまま渡す）
+        bool enabled = false;
+
+        // alpha-betaフィルタの位置・速度ゲイン
+        float alpha = 0.6f;
+        float beta  = 0.2f;
+
+        // 先読み時間[ms]
+        uint32_t lookahead = 0;
+
+        // センサの更新周期[us]（速度推定に使う時間差の下限）
+        uint32_t sensor_period = 16667;
+
+        // 先読みした座標をパネル内に収めるための大きさ（0の場合は収めない）
+        uint16_t width  = 0;
+        uint16_t height = 0;
+    };
+
+    /* タッチ点ごとにalpha-betaフィルタで位置・速度を推定し、先読み位置を予測するクラス */
+    class TouchPredictor
+    {
+    public:
+        // 同時に追跡するタッチ点の最大数
+        static constexpr uint32_t MAX_TOUCHES = 16;
+
+        TouchPredictor() noexcept;
+        TouchPredictor(PredictorConfig config) noexcept;
+
+        // タッチ点が追加された際の処理
+        TouchInfo touch(const TouchInfo& ti);
+
+        // タッチ点が移動した際の処理
+        TouchInfo move(const TouchInfo& ti);
+
+        // タッチ点が削除された際の処理
+        TouchInfo release(const TouchInfo& ti);
+
+        PredictorConfig& getConfig() noexcept { return this->config_; }
+
+    private:
+        /* タッチ点ごとのフィルタ状態 */
+        struct FilterState
+        {
+            bool active = false;
+            uint32_t id = 0;
+
+            float x  = 0.f;
+            float y  = 0.f;
+            float vx = 0.f;
+            float vy = 0.f;
+
+            uint64_t last_time = 0;    // 前回の更新時刻[us]
+        };
+
+        FilterState* find(uint32_t id);
+
+        // 更新の時刻[us]（センサのフレーム時刻が無い場合は受信時刻）
+        static uint64_t timeOf(const TouchInfo& ti);
+
+        // フィルタ状態から配送用のタッチ情報を作成する
+        TouchInfo output(const TouchInfo& ti, const FilterState& fs) const;
+
+        PredictorConfig config_;
+
+        std::array<FilterState, MAX_TOUCHES> filters_;
+
+        std::mutex mutex_;
+    };
+
+}
+
+#endif
@@ -0,0 +1,109 @@
+/**
+ * @file    UdpReactor.hpp
+ * @brief   Single-threaded UDP receive loop for all OSC/TUIO ports
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#ifndef __UDP_REACTOR_HPP__
+#define __UDP_REACTOR_HPP__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ip/PacketListener.h"
+
+#include "OscReceiver.h"
+
+namespace tll
+{
+
+    /* 全ての受信ソケットを1つのepollで待ち受け、各リスナに配送するクラス */
+    class UdpReactor
+    {
+    private:
+        inline static std::unique_ptr<UdpReactor> pInstance_ = nullptr;
+
+    public:
+        UdpReactor();
+        ~UdpReactor();
+
+        static UdpReactor* get()
+        {
+            if (!UdpReactor::pInstance_)
+            {
+                UdpReactor::pInstance_ = std::make_unique<UdpReactor>();
+            }
+
+            return UdpReactor::pInstance_.get();
+        }
+
+        // 指定ポートで受信したパケットをリスナに配送する（初回登録時に受信スレッドを起動）
+        bool listen(int port, PacketListener* listener);
+
+        // リスナの登録を解除し、ソケットを閉じる（受信スレッドが配送中であれば終わるまで待つため、戻った後はリスナを解放してよい）
+        void unlisten(PacketListener* listener);
+
+        // バッファに収まらずに捨てたパケットの数
+        uint64_t getDroppedPackets() const noexcept { return this->dropped_.load(); }
+
+    private:
+        /* 登録されたソケット */
+        struct Entry
+        {
+            int fd;
+            int port;
+            PacketListener* listener;
+        };
+
+        // 受信ループ
+        void run();
+
+        // ソケットに溜まったパケットをまとめて受信して配送する
+        void drain(Entry* entry);
+
+        int epoll_fd_;
+        int wake_fd_;    // 停止・登録解除の確認を受信スレッドに知らせる
+
+        // epollに登録したエントリ
+        std::vector<std::unique_ptr<Entry>> entries_;
+        std::mutex mutex_;
+
+        // 登録解除の要求番号と、受信スレッドが配送を終えたことを確認した番号
+        uint64_t unlisten_seq_;
+        uint64_t ack_seq_;
+        std::condition_variable ack_cv_;
+
+        // 受信スレッド上で解除されたソケット（配送を終えてから閉じる）
+        std::vector<std::unique_ptr<Entry>> deferred_;
+
+        bool stop_;
+        std::thread thread_;
+
+        std::atomic<uint64_t> dropped_{0};
+    };
+
+    /* TUIOクライアント用に、UdpReactor経由でパケットを受け取るレシーバ */
+    class TuioReactorReceiver : public TUIO::OscReceiver
+    {
+    public:
+        TuioReactorReceiver(int port = 3333) noexcept;
+        ~TuioReactorReceiver() override;
+
+        void connect(bool lock = false) override;
+        void disconnect() override;
+        bool isConnected() override { return this->connected_; }
+
+    private:
+        int port_;
+        bool connected_;
+    };
+
+}
+
+#endif
@@ -8,8 +8,15 @@
 #ifndef VIDEO_HPP
 #define VIDEO_HPP
 
+#include <cstdint>
+#include <memory>
+
 #include <opencv2/opencv.hpp>
 
+#include "PanelManager.hpp"
+#include "VideoDecoder.hpp"
+#include "VideoFile.hpp"
+
 namespace tll
 {
     /**
@@ -20,15 +27,59 @@ namespace tll
     public:
         Video();
         Video(cv::VideoCapture video);
+        Video(std::unique_ptr<VideoFile> file);
+        ~Video();
+
+        Video(Video&&) noexcept;
+        Video& operator=(Video&&) noexcept;
+
+        /**
+         * @fn  bool start(uint16_t width, uint16_t height, double max_fps)
+         * @brief  Start decoding in background, scaled to width x height (0 keeps the original size, ignored for .tllvid)
+         */
+        bool start(uint16_t width = 0, uint16_t height = 0, double max_fps = 30.0);
+
+        /**
+         * @fn  bool frameAt(double time)
+         * @brief  Select the newest decoded frame at time [s] without waiting (false if none is ready yet)
+         */
+        bool frameAt(double time);
+
+        /**
+         * @fn  void drawCurrent(int32_t x, int32_t y)
+         * @brief  Draw the frame selected by frameAt()
+         */
+        void drawCurrent(int32_t x, int32_t y) const;
+
+        /**
+         * @fn  bool isFinished()
+         * @brief  All frames were shown
+         */
+        bool isFinished() const;
+
+        double getFps() const;
+        double getDuration() const;
 
         /**
          * @fn  void play()
+         * @brief  Play the whole video and return (blocks the caller, prefer frameAt() and drawCurrent())
          */
         void play(uint32_t pos_x, uint32_t pos_y, uint32_t size_rate = 1);
 
     private:
-        /// Video data
+        /// Video data (moved to the decoder on start)
         cv::VideoCapture video_data_;
+
+        /// Background decoder
+        std::unique_ptr<VideoDecoder> decoder_;
+
+        /// Frame selected by frameAt()
+        VideoFrame current_;
+
+        /// Pre-transcoded video played from the mapped file instead of decoding
+        std::unique_ptr<VideoFile> file_;
+        SurfaceView file_frame_ = SurfaceView{ 0, 0, nullptr };
+        bool file_finished_ = false;
     };
 }
 
@@ -0,0 +1,90 @@
+/**
+ * @file    VideoDecoder.hpp
+ * @brief   Background video decoder filling a bounded queue of panel-sized frames
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#ifndef __VIDEO_DECODER_HPP__
+#define __VIDEO_DECODER_HPP__
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "PanelManager.hpp"
+
+namespace tll
+{
+
+    /* 描画する大きさに縮小し、パネルと同じ形式に変換したフレーム */
+    struct VideoFrame
+    {
+        uint32_t index = 0;    // 動画内のフレーム番号
+        bool valid = false;
+        Surface surface;
+    };
+
+    /* 裏のスレッドで動画をデコードし、再生位置より先のフレームを一定数だけ溜めておく */
+    class VideoDecoder
+    {
+    public:
+        // max_fps を超えるフレームと、再生位置に追いつくまでのフレームはデコードせずに読み飛ばす
+        VideoDecoder(cv::VideoCapture capture, uint16_t width, uint16_t height, double max_fps, uint32_t capacity = 4);
+        ~VideoDecoder();
+
+        VideoDecoder(const VideoDecoder&) = delete;
+        VideoDecoder& operator=(const VideoDecoder&) = delete;
+
+        // index以前で最も新しいフレームをcurrentと入れ替える（currentが変わった場合はtrue、待たない）
+        bool acquire(uint32_t index, VideoFrame& current);
+
+        // 最後のフレームまでデコードし、全て受け取られたか
+        bool isFinished();
+
+        double getFps() const noexcept { return this->fps_; }
+        uint32_t getFrameCount() const noexcept { return this->frame_count_; }
+
+        // デコードせずに読み飛ばしたフレーム数
+        uint64_t getSkippedFrames();
+
+    private:
+        void threadDecode();
+
+        // デコードしたフレームを縮小して変換する
+        void convert(const cv::Mat& frame, Surface& surface);
+
+        cv::VideoCapture capture_;
+        cv::Mat scaled_;
+
+        uint16_t width_;
+        uint16_t height_;
+        double fps_;
+        uint32_t frame_count_;
+        uint32_t step_;        // デコードするフレームの間隔
+        uint32_t capacity_;    // 溜めておくフレームの最大数
+
+        std::deque<VideoFrame> queue_;
+        std::vector<Surface> pool_;    // 受け取り済みのフレームの画素（再利用する）
+
+        uint32_t wanted_;       // 再生側が最後に要求したフレーム番号
+        uint32_t seek_to_;
+        bool seek_;             // 巻き戻しの要求
+        uint32_t generation_;   // 巻き戻すたびに増やし、それ以前にデコードしたフレームを捨てる
+        bool eof_;
+        bool stop_;
+        uint64_t skipped_;
+
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        std::thread thread_;
+    };
+
+}
+
+#endif
@@ -0,0 +1,120 @@
+/**
+ * @file    VideoFile.hpp
+ * @brief   Memory-mapped panel-resolution video (.tllvid)
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#ifndef __VIDEO_FILE_HPP__
+#define __VIDEO_FILE_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "Color.hpp"
+#include "PanelManager.hpp"
+
+namespace tll
+{
+
+    /*
+     * .tllvid の形式（リトルエンディアン）
+     *
+     *   Header
+     *   各フレームのデータ
+     *   FrameEntryの表（header.index_offsetから frame_count 個）
+     *
+     * フレームの画素は左上から行順に並べた width * height 個のRGB
+     *   RAW:   画素をそのまま並べる
+     *   RLE:   [個数-1 (1バイト)][Color] の繰り返し
+     *   DELTA: 直前のフレームとの差分。先頭バイトの最上位ビットが0なら (下位7ビット+1) 個の画素を前のフレームのまま残し、
+     *          1なら (下位7ビット+1) 個のColorが続き、それで置き換える
+     */
+    namespace vid
+    {
+        // ファイルの識別子
+        constexpr char MAGIC[8] = { 'T', 'L', 'L', 'V', 'I', 'D', '\0', '\0' };
+        constexpr uint32_t VERSION = 1;
+
+        // DELTAの1命令で扱える画素数と、置き換えを表すビット
+        constexpr uint32_t MAX_RUN = 128;
+        constexpr uint8_t LITERAL = 0x80;
+
+        /* フレームの符号化方式 */
+        enum class EFrame : uint8_t
+        {
+            RAW,
+            RLE,
+            DELTA,
+        };
+
+        struct Header
+        {
+            char magic[8];
+            uint32_t version;
+            uint16_t width;
+            uint16_t height;
+            uint32_t frame_count;
+            uint32_t fps_num;    // フレームレート = fps_num / fps_den
+            uint32_t fps_den;
+            uint32_t key_interval;    // 単独で復元できるフレームの間隔（シーク時に復元するフレーム数の上限）
+            uint64_t index_offset;
+        };
+
+        struct FrameEntry
+        {
+            uint64_t offset;
+            uint32_t size;
+            uint32_t key;    // このフレームの復元を始める、単独で復元できるフレームの番号
+            EFrame type;
+            uint8_t reserved[7];
+        };
+
+        static_assert(sizeof(Color) == 3, "Pixels are stored as packed RGB");
+        static_assert(sizeof(Header) == 40, "Unexpected header layout");
+        static_assert(sizeof(FrameEntry) == 24, "Unexpected frame entry layout");
+    }
+
+    /* .tllvid ファイルを読み取り専用でマップし、指定フレームを復元する */
+    class VideoFile
+    {
+    public:
+        VideoFile() noexcept;
+        ~VideoFile();
+
+        VideoFile(const VideoFile&) = delete;
+        VideoFile& operator=(const VideoFile&) = delete;
+
+        // ファイルをマップしてフレームの表を読み込む（形式が不正な場合はfalse）
+        bool open(const std::string& path);
+
+        void close() noexcept;
+
+        // 指定フレームの画素（RAWはマップした領域をそのまま返し、それ以外は内部のバッファに復元する）
+        // 直前に返したフレームの続きであれば差分だけを適用し、それ以外は最寄りのキーフレームから復元する
+        SurfaceView frame(uint32_t index);
+
+        uint16_t getWidth() const noexcept { return this->header_ ? this->header_->width : 0; }
+        uint16_t getHeight() const noexcept { return this->header_ ? this->header_->height : 0; }
+        uint32_t getFrameCount() const noexcept { return this->header_ ? this->header_->frame_count : 0; }
+        double getFps() const noexcept;
+
+    private:
+        // 1フレーム分のデータを内部のバッファに適用する（データが壊れている場合はfalse）
+        bool decode(uint32_t index);
+
+        const uint8_t* data_;
+        size_t size_;
+
+        const vid::Header* header_;
+        const vid::FrameEntry* frames_;
+
+        // 復元したフレームと、その番号（無効な場合はUINT32_MAX）
+        Surface buffer_;
+        uint32_t buffer_index_;
+    };
+
+}
+
+#endif
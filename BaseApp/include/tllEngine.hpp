@@ -15,7 +15,10 @@
 namespace tll
 {
 
+    class IAssetManager;
+    class ICommandBus;
     class IEventHandler;
+    class ILatencyTracer;
     class IPanelManager;
     class ISerialManager;
     class ITextRenderer;
@@ -55,7 +58,10 @@ namespace tll
             tllComponent<IEventHandler>,
             tllComponent<IPanelManager>,
             tllComponent<ISerialManager>,
-            tllComponent<ITextRenderer>
+            tllComponent<ITextRenderer>,
+            tllComponent<ILatencyTracer>,
+            tllComponent<ICommandBus>,
+            tllComponent<IAssetManager>
         > components_;
 
         bool initialized_;
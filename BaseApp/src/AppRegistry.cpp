@@ -0,0 +1,44 @@
+/**
+ * @file    AppRegistry.cpp
+ * @brief   Static registration of apps linked into the base app
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#include "AppRegistry.hpp"
+
+#include <cstring>
+
+namespace tll
+{
+
+    bool AppRegistry::add(const char* name, createApp* create)
+    {
+        table().push_back(Entry{ name, create });
+        return true;
+    }
+
+    createApp* AppRegistry::find(const char* name)
+    {
+        for (const Entry& entry : table())
+        {
+            if (std::strcmp(entry.name, name) == 0)
+                return entry.create;
+        }
+
+        return nullptr;
+    }
+
+    const std::vector<AppRegistry::Entry>& AppRegistry::entries()
+    {
+        return table();
+    }
+
+    std::vector<AppRegistry::Entry>& AppRegistry::table()
+    {
+        // 他の翻訳単位の静的変数の初期化から呼ばれるため、初回の呼び出し時に作成する
+        static std::vector<Entry> entries;
+        return entries;
+    }
+
+}
@@ -0,0 +1,262 @@
+/**
+ * @file    AssetManager.cpp
+ * @brief   Deduplicating cache of decoded images and fonts
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#include "AssetManager.hpp"
+
+#include <exception>
+#include <filesystem>
+#include <iostream>
+
+#include "AssetPack.hpp"
+#include "Common.hpp"
+#include "Image.hpp"
+
+namespace tll
+{
+
+    IAssetManager* IAssetManager::create()
+    {
+        return new AssetManager();
+    }
+
+    AssetManager::AssetManager() noexcept
+        : budget_(32 * 1024 * 1024)
+        , use_clock_(0)
+        , stats_{}
+        , stop_(false)
+    {
+        printLog("Create Asset manager");
+    }
+
+    AssetManager::~AssetManager()
+    {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex_);
+            this->stop_ = true;
+        }
+        this->warm_cv_.notify_all();
+
+        if (this->warm_thread_.joinable())
+            this->warm_thread_.join();
+
+        printLog("Destroy Asset manager");
+    }
+
+    std::shared_ptr<const Image> AssetManager::getImage(const std::string& path, uint16_t width, uint16_t height)
+    {
+        std::string key = "image:" + path + "@" + std::to_string(width) + "x" + std::to_string(height);
+
+        return std::static_pointer_cast<const Image>(this->acquire(key, [&path, width, height](uint64_t& bytes) -> std::shared_ptr<void>
+        {
+            cv::Mat img = cv::imread(path);
+            if (img.empty())
+                return nullptr;
+
+            auto image = std::make_shared<Image>(img);
+            if (width != 0 && height != 0)
+                image->resize(height, width);
+
+            // 元の画像データ・変換済みの画素・マスク
+            bytes = static_cast<uint64_t>(img.rows) * img.cols * 3
+                  + static_cast<uint64_t>(image->getWidth()) * image->getHeight() * (sizeof(Color) + 1);
+
+            return image;
+        }));
+    }
+
+    std::shared_ptr<Font> AssetManager::getFont(const std::string& path)
+    {
+        std::string key = "font:" + path;
+
+        return std::static_pointer_cast<Font>(this->acquire(key, [&path](uint64_t& bytes) -> std::shared_ptr<void>
+        {
+            std::error_code ec;
+            bytes = std::filesystem::file_size(path, ec);
+            if (ec)
+                return nullptr;
+
+            auto font = std::make_shared<Font>();
+            font->ft2 = cv::freetype::createFreeType2();
+            font->ft2->loadFontData(path.c_str(), 0);
+
+            return font;
+        }));
+    }
+
+    std::shared_ptr<const AssetPack> AssetManager::getPack(const std::string& path)
+    {
+        std::string key = "pack:" + path;
+
+        return std::static_pointer_cast<const AssetPack>(this->acquire(key, [&path](uint64_t& bytes) -> std::shared_ptr<void>
+        {
+            auto pack = std::make_shared<AssetPack>();
+            if (!pack->open(path))
+                return nullptr;
+
+            // マップした領域はページキャッシュから必要な分だけ読まれ、いつでも捨てられるため使用量に数えない
+            bytes = 0;
+
+            return pack;
+        }));
+    }
+
+    void AssetManager::warm(const std::vector<std::string>& paths)
+    {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex_);
+
+            this->warm_queue_.insert(this->warm_queue_.end(), paths.begin(), paths.end());
+
+            if (!this->warm_thread_.joinable())
+                this->warm_thread_ = std::thread(&AssetManager::threadWarm, this);
+        }
+
+        this->warm_cv_.notify_one();
+    }
+
+    void AssetManager::setMemoryBudget(uint64_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        this->budget_ = bytes;
+        this->evict();
+    }
+
+    AssetStats AssetManager::getStats()
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        AssetStats stats = this->stats_;
+        stats.entries = static_cast<uint32_t>(this->entries_.size());
+
+        return stats;
+    }
+
+    std::shared_ptr<void> AssetManager::acquire(const std::string& key, const Loader& load)
+    {
+        std::promise<std::shared_ptr<void>> promise;
+
+        {
+            std::unique_lock<std::mutex> lock(this->mutex_);
+
+            auto it = this->entries_.find(key);
+            if (it != this->entries_.end())
+            {
+                it->second.last_use = ++this->use_clock_;
+                this->stats_.hits++;
+
+                // 他のスレッドが読み込み中の場合は完了を待つ
+                std::shared_future<std::shared_ptr<void>> value = it->second.value;
+                lock.unlock();
+
+                return value.get();
+            }
+
+            Entry entry;
+            entry.value = promise.get_future().share();
+            entry.last_use = ++this->use_clock_;
+            this->entries_.emplace(key, entry);
+            this->stats_.misses++;
+        }
+
+        // デコードはロックの外で行う
+        uint64_t bytes = 0;
+        std::shared_ptr<void> asset;
+
+        try
+        {
+            asset = load(bytes);
+        }
+        catch (...)
+        {
+            // 待っているスレッドにも例外を渡し、次の要求で読み込み直せるようにする
+            promise.set_exception(std::current_exception());
+
+            std::lock_guard<std::mutex> lock(this->mutex_);
+            this->entries_.erase(key);
+            throw;
+        }
+
+        promise.set_value(asset);
+
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        auto it = this->entries_.find(key);
+        if (it == this->entries_.end())
+            return asset;
+
+        // 読み込めなかった場合は次の要求で読み込み直す
+        if (!asset)
+        {
+            this->entries_.erase(it);
+            return asset;
+        }
+
+        it->second.bytes = bytes;
+        this->stats_.bytes += bytes;
+        this->evict();
+
+        return asset;
+    }
+
+    void AssetManager::evict()
+    {
+        while (this->stats_.bytes > this->budget_)
+        {
+            auto victim = this->entries_.end();
+
+            for (auto it = this->entries_.begin(); it != this->entries_.end(); ++it)
+            {
+                const auto& value = it->second.value;
+
+                // 読み込み中・使用中の資産と、解放しても使用量が減らない資産（マップしたパック）は解放しない
+                if (it->second.bytes == 0 || value.wait_for(std::chrono::seconds(0)) != std::future_status::ready || value.get().use_count() > 1)
+                    continue;
+
+                if (victim == this->entries_.end() || it->second.last_use < victim->second.last_use)
+                    victim = it;
+            }
+
+            if (victim == this->entries_.end())
+                break;
+
+            this->stats_.bytes -= victim->second.bytes;
+            this->stats_.evictions++;
+            this->entries_.erase(victim);
+        }
+    }
+
+    void AssetManager::threadWarm()
+    {
+        while (true)
+        {
+            std::string path;
+
+            {
+                std::unique_lock<std::mutex> lock(this->mutex_);
+                this->warm_cv_.wait(lock, [this]() { return this->stop_ || !this->warm_queue_.empty(); });
+
+                if (this->stop_)
+                    return;
+
+                path = this->warm_queue_.front();
+                this->warm_queue_.pop_front();
+            }
+
+            try
+            {
+                if (!this->getImage(path))
+                    std::cerr << "[ERROR] Failed to warm " << path << std::endl;
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << "[ERROR] Failed to warm " << path << ": " << e.what() << std::endl;
+            }
+        }
+    }
+
+}
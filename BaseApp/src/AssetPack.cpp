@@ -0,0 +1,278 @@
+/**
+ * @file    AssetPack.cpp
+ * @brief   Memory-mapped asset pack (.tllpak) of panel-native images and glyphs
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#include "AssetPack.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "tllEngine.hpp"
+
+namespace tll
+{
+
+    void PackImage::draw(int32_t x, int32_t y) const
+    {
+        TLL_ENGINE(PanelManager)->drawSurface(x, y, this->surface);
+    }
+
+    void PackImage::draw(int32_t x, int32_t y, Color color) const
+    {
+        TLL_ENGINE(PanelManager)->drawMask(x, y, this->mask, color, false);
+    }
+
+    void PackImage::drawTransparent(int32_t x, int32_t y) const
+    {
+        TLL_ENGINE(PanelManager)->drawSurfaceMasked(x, y, this->surface, this->mask);
+    }
+
+    void PackImage::drawTransparent(int32_t x, int32_t y, Color color) const
+    {
+        TLL_ENGINE(PanelManager)->drawMask(x, y, this->mask, color, true);
+    }
+
+    const pak::Glyph* PackFont::find(uint32_t codepoint) const noexcept
+    {
+        // グリフはコードポイント順に並んでいる
+        const pak::Glyph* end = this->glyphs + this->count;
+        const pak::Glyph* it = std::lower_bound(this->glyphs, end, codepoint, [](const pak::Glyph& g, uint32_t cp)
+        {
+            return g.codepoint < cp;
+        });
+
+        if (it == end || it->codepoint != codepoint)
+            return nullptr;
+
+        return it;
+    }
+
+    uint32_t PackFont::drawText(const std::string& text, int32_t x, int32_t y, Color color) const
+    {
+        IPanelManager* panel = TLL_ENGINE(PanelManager);
+        int32_t pen = x;
+
+        size_t pos = 0;
+        while (pos < text.size())
+        {
+            uint32_t codepoint;
+            if (!pak::decodeUtf8(text, pos, codepoint))
+                continue;
+
+            const pak::Glyph* glyph = this->find(codepoint);
+            if (glyph == nullptr)
+                continue;
+
+            MaskView mask{
+                glyph->width,
+                glyph->height,
+                glyph->words,
+                reinterpret_cast<const uint64_t*>(this->base + glyph->mask_offset)
+            };
+            panel->drawMask(pen, y, mask, color, true);
+
+            pen += glyph->advance;
+        }
+
+        return static_cast<uint32_t>(pen - x);
+    }
+
+    uint32_t PackFont::textWidth(const std::string& text) const noexcept
+    {
+        uint32_t width = 0;
+
+        size_t pos = 0;
+        while (pos < text.size())
+        {
+            uint32_t codepoint;
+            if (!pak::decodeUtf8(text, pos, codepoint))
+                continue;
+
+            if (const pak::Glyph* glyph = this->find(codepoint))
+                width += glyph->advance;
+        }
+
+        return width;
+    }
+
+    AssetPack::AssetPack() noexcept
+        : data_(nullptr)
+        , size_(0)
+    {
+    }
+
+    AssetPack::~AssetPack()
+    {
+        this->close();
+    }
+
+    bool AssetPack::open(const std::string& path)
+    {
+        this->close();
+
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            std::cerr << "[ERROR] Failed to open asset pack " << path << std::endl;
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(pak::Header))
+        {
+            std::cerr << "[ERROR] Invalid asset pack " << path << std::endl;
+            ::close(fd);
+            return false;
+        }
+
+        // 読み取り専用で共有すると、同じパックを開いた他のプロセスともページキャッシュを共有できる
+        void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+
+        if (data == MAP_FAILED)
+        {
+            std::cerr << "[ERROR] Failed to map asset pack " << path << std::endl;
+            return false;
+        }
+
+        this->data_ = static_cast<const uint8_t*>(data);
+        this->size_ = static_cast<size_t>(st.st_size);
+
+        const pak::Header* header = reinterpret_cast<const pak::Header*>(this->data_);
+        if (std::memcmp(header->magic, pak::MAGIC, sizeof(pak::MAGIC)) != 0 || header->version != pak::VERSION
+            || header->index_offset % pak::ALIGN != 0
+            || !this->contains(header->index_offset, static_cast<uint64_t>(header->entry_count) * sizeof(pak::Entry)))
+        {
+            std::cerr << "[ERROR] Invalid asset pack " << path << std::endl;
+            this->close();
+            return false;
+        }
+
+        const pak::Entry* entries = reinterpret_cast<const pak::Entry*>(this->data_ + header->index_offset);
+        for (uint32_t i = 0; i < header->entry_count; i++)
+        {
+            const pak::Entry& entry = entries[i];
+
+            if (entry.name[pak::NAME_SIZE - 1] != '\0' || !this->validate(entry))
+            {
+                std::cerr << "[ERROR] Broken entry in asset pack " << path << std::endl;
+                this->close();
+                return false;
+            }
+
+            this->index_[entry.name] = &entry;
+        }
+
+        return true;
+    }
+
+    void AssetPack::close() noexcept
+    {
+        if (this->data_ != nullptr)
+            munmap(const_cast<uint8_t*>(this->data_), this->size_);
+
+        this->data_ = nullptr;
+        this->size_ = 0;
+        this->index_.clear();
+    }
+
+    bool AssetPack::findImage(const std::string& name, PackImage& image) const
+    {
+        const pak::Entry* entry = this->lookup(name, pak::EEntry::IMAGE);
+        if (entry == nullptr)
+            return false;
+
+        image.surface = SurfaceView{
+            entry->width,
+            entry->height,
+            reinterpret_cast<const Color*>(this->data_ + entry->data_offset)
+        };
+        image.mask = MaskView{
+            entry->width,
+            entry->height,
+            entry->words,
+            reinterpret_cast<const uint64_t*>(this->data_ + entry->mask_offset)
+        };
+        image.pack = this->weak_from_this().lock();
+
+        return true;
+    }
+
+    bool AssetPack::findFont(const std::string& name, PackFont& font) const
+    {
+        const pak::Entry* entry = this->lookup(name, pak::EEntry::FONT);
+        if (entry == nullptr)
+            return false;
+
+        font.base = this->data_;
+        font.glyphs = reinterpret_cast<const pak::Glyph*>(this->data_ + entry->data_offset);
+        font.count = entry->count;
+        font.line_height = entry->height;
+        font.pack = this->weak_from_this().lock();
+
+        return true;
+    }
+
+    bool AssetPack::contains(uint64_t offset, uint64_t bytes) const noexcept
+    {
+        return offset <= this->size_ && bytes <= this->size_ - offset;
+    }
+
+    bool AssetPack::validate(const pak::Entry& entry) const noexcept
+    {
+        auto mask_ok = [this](uint64_t offset, uint16_t width, uint16_t height, uint16_t words)
+        {
+            return offset % pak::ALIGN == 0 && words == (width + 63) / 64
+                && this->contains(offset, static_cast<uint64_t>(words) * height * sizeof(uint64_t));
+        };
+
+        switch (entry.type)
+        {
+        case pak::EEntry::IMAGE:
+            return this->contains(entry.data_offset, static_cast<uint64_t>(entry.width) * entry.height * sizeof(Color))
+                && mask_ok(entry.mask_offset, entry.width, entry.height, entry.words);
+
+        case pak::EEntry::FONT:
+        {
+            if (entry.data_offset % pak::ALIGN != 0
+                || !this->contains(entry.data_offset, static_cast<uint64_t>(entry.count) * sizeof(pak::Glyph)))
+                return false;
+
+            // 描画時に検査しなくて済むよう、全てのグリフをここで確かめる
+            const pak::Glyph* glyphs = reinterpret_cast<const pak::Glyph*>(this->data_ + entry.data_offset);
+            for (uint32_t i = 0; i < entry.count; i++)
+            {
+                if (i > 0 && glyphs[i - 1].codepoint >= glyphs[i].codepoint)
+                    return false;
+
+                if (!mask_ok(glyphs[i].mask_offset, glyphs[i].width, glyphs[i].height, glyphs[i].words))
+                    return false;
+            }
+
+            return true;
+        }
+
+        default:
+            return false;
+        }
+    }
+
+    const pak::Entry* AssetPack::lookup(const std::string& name, pak::EEntry type) const
+    {
+        auto it = this->index_.find(name);
+        if (it == this->index_.end() || it->second->type != type)
+            return nullptr;
+
+        return it->second;
+    }
+
+}
@@ -1,19 +1,38 @@
 #include "BaseApp.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <cerrno>
 #include <chrono>
 #include <dlfcn.h>
 #include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
 #include <thread>
+#include <unordered_set>
 
+#include <csignal>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
 #include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
 #include <iostream>
 #include <termios.h>
 #include <unistd.h>
 
 #include "AppInterface.hpp"
+#include "AppRegistry.hpp"
+#include "BlobDetector.hpp"
+#include "CommandBus.hpp"
+#include "Event.hpp"
 #include "OscHandler.hpp"
+#include "RemoteApp.hpp"
+#include "SerialManager.hpp"
+#include "UdpReactor.hpp"
 
 #include "ip/UdpSocket.h"
 #include "ip/IpEndpointName.h"
@@ -34,12 +53,84 @@ namespace tll
             #elif __linux__
             ".so";
             #endif
+
+        // ホーム画面のアイコンの位置と色（通常・押下中）
+        constexpr uint16_t ICON_X[3] = { 3, 24, 45 };
+        constexpr uint16_t ICON_Y    = 8;
+        constexpr uint16_t ICON_SIZE = 15;
+
+        constexpr tll::Color ICON_COLOR[3][2] = {
+            { tll::Color(255,   0,   0), tll::Color(100,   0,   0) },
+            { tll::Color(  0, 255,   0), tll::Color(  0, 100,   0) },
+            { tll::Color(  0, 128, 255), tll::Color(  0,   0, 100) },
+        };
+
+        // 一覧に無いDLLのファイル名（lib<アプリ名>.so）からアプリ名を得る（該当しない名前はfalse）
+        bool appNameFromFile(const std::filesystem::path& path, std::string& app_name)
+        {
+            std::string stem = path.stem().string();
+            if (path.extension() != extention || stem.size() <= 3 || stem.compare(0, 3, "lib") != 0)
+                return false;
+
+            app_name = stem.substr(3);
+            return true;
+        }
+
+        // 異常終了したプロセスが残したDLLのコピー（名前は stem.PID.版数.XXXXXX.so）を削除する
+        void removeStaleCopies(const std::filesystem::path& dir)
+        {
+            std::error_code ec;
+            for (const auto& file : std::filesystem::directory_iterator(dir, ec))
+            {
+                std::string name = file.path().stem().string();
+
+                // 末尾の「.版数.XXXXXX」を除いた直前がPID
+                size_t end = name.rfind('.');
+                end = (end == std::string::npos || end == 0) ? std::string::npos : name.rfind('.', end - 1);
+                size_t begin = (end == std::string::npos || end == 0) ? std::string::npos : name.rfind('.', end - 1);
+                if (begin == std::string::npos)
+                    continue;
+
+                pid_t pid = static_cast<pid_t>(std::atol(name.substr(begin + 1, end - begin - 1).c_str()));
+                if (pid > 0 && kill(pid, 0) != 0 && errno == ESRCH)
+                    std::filesystem::remove(file.path(), ec);
+            }
+        }
+
+        // プロセスの起動（exec）からの経過時間[ms]（取得できない場合は負の値）
+        double elapsedSinceExec()
+        {
+            std::ifstream stat("/proc/self/stat");
+            std::string line;
+            if (!std::getline(stat, line))
+                return -1.0;
+
+            // コマンド名に空白が含まれる場合があるため、閉じ括弧の後から数える
+            size_t pos = line.rfind(')');
+            if (pos == std::string::npos)
+                return -1.0;
+
+            // 3番目の項目（state）から数えて20番目が起動時刻（起動後のクロック数）
+            std::istringstream fields(line.substr(pos + 1));
+            std::string field;
+            for (int i = 0; i < 20; i++)
+            {
+                if (!(fields >> field))
+                    return -1.0;
+            }
+
+            struct timespec ts;
+            clock_gettime(CLOCK_BOOTTIME, &ts);
+
+            double start_sec = std::stod(field) / sysconf(_SC_CLK_TCK);
+            return (ts.tv_sec + ts.tv_nsec * 1e-9 - start_sec) * 1000.0;
+        }
     }
 
     BaseApp::BaseApp()
         : is_home_(true)
     {
-        this->osc_receiver = new TUIO::UdpReceiver();
+        this->osc_receiver = new TuioReactorReceiver();
         this->tuio_client  = new TUIO::TuioClient(this->osc_receiver);
         this->tuio_client->addTuioListener(this);
         this->tuio_client->connect();
@@ -52,7 +143,22 @@ namespace tll
 
     BaseApp::~BaseApp()
     {
+        if (this->watch_thread_.joinable())
+            this->watch_thread_.join();
+        if (this->preload_thread_.joinable())
+            this->preload_thread_.join();
+        {
+            std::lock_guard<std::mutex> lock(this->switch_mutex_);
+            this->prepare_stop_ = true;
+        }
+        this->prepare_cv_.notify_one();
+        if (this->prepare_thread_.joinable())
+            this->prepare_thread_.join();
+        if (this->prepared_app_ && this->prepared_inited_)
+            this->prepared_app_->terminate();
+
         tll::OscHandler::sendMessage("/tll/terminate", "192.168.0.100", 3333);
+        tll::OscHandler::flush(true);
         this->tuio_client->disconnect();
         delete this->tuio_client;
         delete this->osc_receiver;
@@ -62,21 +168,104 @@ namespace tll
     {
         init(64, 32, "HUB75");
 
-        this->loadApps();
+        this->predictor_.getConfig().width  = TLL_ENGINE(PanelManager)->getWidth();
+        this->predictor_.getConfig().height = TLL_ENGINE(PanelManager)->getHeight();
+
+        // 赤外線センサ画像からのタッチ検出をプロセス内で行う
+        if (!this->ir_endpoint_.empty())
+        {
+            std::thread ir_thread(threadReceiveIrFrame, this->ir_endpoint_);
+            ir_thread.detach();
+        }
+
+        // ホーム画面のアイコン領域を登録
+        this->home_regions_.init(64, 32);
+        for (int i = 0; i < 3; i++)
+            this->icon_region_[i] = this->home_regions_.addRect(ICON_X[i], ICON_Y, ICON_SIZE, ICON_SIZE);
+
+        // ホーム画面はアイコンの押下状態ごとに焼き込んでおき、フレームごとには描画しない
+        for (uint8_t pressed = 0; pressed < this->launcher_layers_.size(); pressed++)
+            this->bakeLauncherLayer(pressed);
+
+        // DLLは起動時に読み込まず、一覧の登録だけを行う
+        std::chrono::steady_clock::time_point index_tp = std::chrono::steady_clock::now();
+        uint32_t app_num = this->loadApps();
+        uint32_t index_us = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - index_tp
+        ).count());
+
+        // アプリの更新を監視する
+        this->watch_thread_ = std::thread(&BaseApp::threadWatchApps, this);
+
+        // イベント配送数の計測用
+        EventStats last_stats = getEventStats();
+        uint64_t last_delivered = this->delivered_num_;
+        std::chrono::steady_clock::time_point last_count_tp = std::chrono::steady_clock::now();
+
+        uint64_t frame_num = 0;
 
         while (loop())
         {
             static uint32_t count = 0;    // アニメーション用カウンタ
 
+            // 最初のフレームを送り終えたら起動時間を表示し、よく使うアプリを裏で読み込み始める
+            if (++frame_num == 2)
+            {
+                std::cout << "[Startup] first frame: " << elapsedSinceExec() << " ms after exec"
+                          << " (" << app_num << " apps registered in " << (index_us / 1000.0) << " ms)" << std::endl;
+
+                this->preload_thread_ = std::thread(&BaseApp::threadPreloadApps, this);
+            }
+
+            if (this->count_events_)
+            {
+                std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+                if (now - last_count_tp >= std::chrono::seconds(1))
+                {
+                    EventStats stats = getEventStats();
+                    uint64_t delivered = this->delivered_num_;
+
+                    std::cout << "[Event] osc: "    << (stats.osc_received - last_stats.osc_received) << "/s"
+                              << ", tuio: "         << (stats.tuio_sent - last_stats.tuio_sent) << "/s"
+                              << ", app: "          << (delivered - last_delivered) << "/s"
+                              << ", dropped: "      << (stats.dropped - last_stats.dropped) << "/s"
+                              << " (total " << stats.dropped << ")" << std::endl;
+
+                    LatencyStats latency = getLatencyStats();
+                    std::cout << "[Latency] p50/p99[us]"
+                              << " osc->tuio: "   << latency.osc_to_tuio.p50  << "/" << latency.osc_to_tuio.p99
+                              << ", tuio->base: " << latency.tuio_to_base.p50 << "/" << latency.tuio_to_base.p99
+                              << ", base->app: "  << latency.base_to_app.p50  << "/" << latency.base_to_app.p99
+                              << ", app->frame: " << latency.app_to_frame.p50 << "/" << latency.app_to_frame.p99
+                              << ", total: "      << latency.total.p50        << "/" << latency.total.p99
+                              << " (" << latency.total.count << " traces)" << std::endl;
+
+                    last_stats = stats;
+                    last_delivered = delivered;
+                    last_count_tp = now;
+                }
+            }
+
             std::this_thread::sleep_for(std::chrono::milliseconds(33));
 
+            // 制御コマンド・更新されたアプリと、準備の終わったアプリへの切り替えはフレームの境界で適用する
+            this->applyReloads();
+            this->applyCommands();
+            this->applySwitch();
+
             // ホーム画面の表示
             if (this->is_home_)
             {
-                clear();
-                this->icon_img->draw( 3, 8, (!this->icon_pressed[0] ? tll::Color(255,   0,   0) : tll::Color(100,   0,   0)));
-                this->icon_img->draw(24, 8, (!this->icon_pressed[1] ? tll::Color(  0, 255,   0) : tll::Color(  0, 100,   0)));
-                this->icon_img->draw(45, 8, (!this->icon_pressed[2] ? tll::Color(  0, 128, 255) : tll::Color(  0,   0, 100)));
+                uint8_t pressed = 0;
+                for (int i = 0; i < 3; i++)
+                    pressed |= (this->icon_pressed[i] ? 1 : 0) << i;
+
+                // 押下状態が変わった場合とアニメーション中のみ、焼き込んだ画面で描き直す
+                if (pressed != this->launcher_shown_ || this->is_playing_anim != -1)
+                    TLL_ENGINE(PanelManager)->blit(0, 0, this->launcher_layers_[pressed]);
+
+                // アニメーション中は円を上書きするため、次のフレームでも描き直す
+                this->launcher_shown_ = (this->is_playing_anim == -1) ? pressed : LAUNCHER_DIRTY;
 
                 // 開始時アニメーション処理
                 if (this->is_playing_anim != -1)
@@ -89,7 +278,7 @@ namespace tll
                         drawCircle(11, 16, count * 2 + 1, tll::Color(255, 0, 0));
                         if (count >= 45)
                         {
-                            this->switchApp("CockroachShooting");
+                            this->switchApp(HOME_APPS[0]);
                         }
                     }
                     else if (this->is_playing_anim == 1)
@@ -97,14 +286,14 @@ namespace tll
                         drawCircle(32, 16, count * 2, tll::Color(0, 255, 0));
                         drawCircle(32, 16, count * 2 + 1, tll::Color(0, 255, 0));
                         if (count >= 45)
-                            this->switchApp("Theremin");
+                            this->switchApp(HOME_APPS[1]);
                     }
                     else if (this->is_playing_anim == 2)
                     {
                         drawCircle(53, 16, count * 2, tll::Color(0, 128, 255));
                         drawCircle(53, 16, count * 2 + 1, tll::Color(0, 128, 255));
                         if (count >= 45)
-                            this->switchApp("ADIR01P_Light");
+                            this->switchApp(HOME_APPS[2]);
                     }
 
                     if (count >= 45)
@@ -116,126 +305,1090 @@ namespace tll
                     }
                 }
 
+                this->composeViewports();
                 continue;
             }
 
             // 起動中アプリケーションの表示など
             if (this->running_app)
             {
-                // 5点タッチ
-                if (getTouchedNum() == 5)
+                // 判定済みジェスチャの配送（5点ホールドでホーム画面に戻る）
+                this->gesture_.update();
+
+                // 5点ホールドの判定時間はアプリ向けのHOLDとは別に、ここでだけ長くする
+                uint32_t held = this->gesture_.getHoldDuration(HOME_HOLD_FINGERS);
+                if (held >= HOME_HOLD_TIME && !this->home_held_)
+                    TLL_ENGINE(CommandBus)->postSwitchApp("home");
+                this->home_held_ = (held >= HOME_HOLD_TIME);
+
+                GestureInfo gi;
+                while (this->gesture_.poll(gi))
                 {
-                    if (!this->back_to_home_flag)
-                    {
-                        this->back_to_home_flag = true;
-                        this->back_to_home_tp = std::chrono::system_clock::now();
+                    // ホームに戻る操作の途中経過はアプリに渡さない
+                    if (gi.type == EGestureType::HOLD && gi.fingers == HOME_HOLD_FINGERS)
                         continue;
-                    }
 
-                    std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
-                    double elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - this->back_to_home_tp).count();
-                    
-                    if (elapsed >= 3.f)
-                    {
-                        OscHandler::sendMessageWithString("/tll/switch", "home", "127.0.0.1", 44101);
-                    }
+                    if (!this->paused_)
+                        this->running_app->onGesture(gi);
                 }
-                else if (this->back_to_home_flag)
+
+                // 予算を超え続けるアプリは品質を下げさせ、それでも超える場合は間引いて呼ぶ
+                if (!this->paused_ && this->watchdog_.begin(this->running_app->getFrameContext()))
                 {
-                    this->back_to_home_flag = false;
+                    this->running_app->run();
+                    this->applyBudgetAction(this->watchdog_.end(this->running_app->getFrameContext()));
                 }
-
-                this->running_app->run();
             }
+
+            this->composeViewports();
         }
 
+        while (!this->viewport_apps_.empty())
+            this->closeViewport(this->viewport_apps_.back()->name);
+
+        this->saveAppIndex();
+
         if (this->running_app)
             this->running_app->terminate();
         quit();
     }
 
+    void BaseApp::bakeLauncherLayer(uint8_t pressed)
+    {
+        Surface& layer = this->launcher_layers_[pressed];
+        layer.resize(TLL_ENGINE(PanelManager)->getWidth(), TLL_ENGINE(PanelManager)->getHeight());
+
+        IPanelManager::setRenderTarget(&layer);
+        for (int i = 0; i < 3; i++)
+            this->icon_img->draw(ICON_X[i], ICON_Y, ICON_COLOR[i][(pressed >> i) & 1]);
+        IPanelManager::setRenderTarget(nullptr);
+    }
+
     bool BaseApp::switchApp(std::string app_name)
     {
-        bool is_found = false;
+        if (app_name != "home" && !this->prepareApp(app_name))
+            return false;
 
-        if (this->running_app)
+        std::lock_guard<std::mutex> lock(this->switch_mutex_);
+
+        this->pending_name_ = app_name;
+        this->switch_request_tp_ = std::chrono::steady_clock::now();
+
+        return true;
+    }
+
+    void BaseApp::applyBudgetAction(EBudgetAction action)
+    {
+        if (action == EBudgetAction::NONE)
+            return;
+
+        const FrameContext& ctx = this->running_app->getFrameContext();
+
+        std::cout << "[Budget] " << this->running_name_ << ": "
+                  << (ctx.last_us / 1000.0) << " ms / " << (ctx.budget_us / 1000.0) << " ms";
+
+        switch (action)
         {
-            this->running_app->terminate();
-            std::this_thread::sleep_for(std::chrono::milliseconds(500));
-            this->running_app.reset();
+        case EBudgetAction::DEGRADE:
+        case EBudgetAction::RESTORE:
+        case EBudgetAction::THROTTLE:
+            std::cout << ", quality " << static_cast<int>(ctx.quality)
+                      << ", run every " << this->watchdog_.getThrottle() << " frames" << std::endl;
+            break;
+
+        case EBudgetAction::DEMOTE:
+        {
+            // 子プロセスで動かし直し、処理落ちがタッチ処理・出力を止めないようにする（動作中の状態は引き継がれない）
+            bool demoted = false;
+            {
+                std::lock_guard<std::mutex> lock(this->switch_mutex_);
+
+                auto it = this->app_list.find(this->running_name_);
+                if (it != this->app_list.end() && !it->second.demoted && !this->isolate_apps_)
+                    demoted = it->second.demoted = true;
+            }
+
+            std::cout << (demoted ? ", demoted to child process" : ", still over budget") << std::endl;
+
+            if (demoted)
+                this->switchApp(this->running_name_);
+            break;
+        }
+
+        default:
+            break;
+        }
+    }
+
+    void BaseApp::applyCommands()
+    {
+        Command cmd;
+        while (TLL_ENGINE(CommandBus)->poll(cmd))
+        {
+            switch (cmd.type)
+            {
+            case ECommand::SWITCH_APP:
+                if (!this->switchApp(cmd.app_name))
+                    std::cerr << "[ERROR] App not found: " << cmd.app_name << std::endl;
+                break;
+
+            case ECommand::PAUSE:
+                this->paused_ = true;
+                break;
+
+            case ECommand::RESUME:
+                this->paused_ = false;
+                break;
+
+            case ECommand::TOGGLE_PAUSE:
+                this->paused_ = !this->paused_;
+                break;
+
+            case ECommand::SET_BRIGHTNESS:
+                TLL_ENGINE(SerialManager)->setBrightness(static_cast<uint8_t>(cmd.value));
+                break;
+
+            case ECommand::OPEN_VIEWPORT:
+                // 負の幅・高さはuint16_tに変換する前に弾く
+                if (cmd.rect[2] <= 0 || cmd.rect[3] <= 0
+                    || !this->openViewport(cmd.app_name, Viewport{ cmd.rect[0], cmd.rect[1], static_cast<uint16_t>(cmd.rect[2]), static_cast<uint16_t>(cmd.rect[3]) }))
+                    std::cerr << "[ERROR] Failed to open viewport: " << cmd.app_name << std::endl;
+                break;
+
+            case ECommand::CLOSE_VIEWPORT:
+                this->closeViewport(cmd.app_name);
+                break;
+            }
+        }
+    }
+
+    bool BaseApp::prepareApp(const std::string& app_name)
+    {
+        std::shared_ptr<void> stale_handle;
+        std::unique_ptr<class AppInterface> stale;
+        bool stale_inited = false;
+
+        {
+            std::lock_guard<std::mutex> lock(this->switch_mutex_);
+
+            auto it = this->app_list.find(app_name);
+            if (it == this->app_list.end())
+                return false;
+
+            // 準備済み、または準備中
+            if (this->prepared_name_ == app_name)
+                return true;
+
+            // 別のアプリを準備していた場合は破棄する（作成中のものは完了時に破棄される）
+            this->prepared_name_ = app_name;
+            stale_handle = std::move(this->prepared_handle_);
+            stale = std::move(this->prepared_app_);
+            stale_inited = this->prepared_inited_;
+            this->prepared_inited_ = false;
+
+            // 起動中のアプリが無ければ、切り替えまでに終了させるアプリも並行して動くアプリも無いため裏で初期化してよい
+            // （running_app はメインループでのみ書き換えるため、ここでの参照はロック不要）
+            this->prepare_job_ = PrepareJob{ app_name, it->second, !this->running_app };
+            this->prepare_job_pending_ = true;
+        }
+
+        // 前の依頼を処理中でも待たずに戻り、準備用のスレッドが続けて新しい依頼を処理する
+        if (!this->prepare_thread_.joinable())
+            this->prepare_thread_ = std::thread(&BaseApp::threadPrepareApps, this);
+        this->prepare_cv_.notify_one();
+
+        if (stale && stale_inited)
+            stale->terminate();
+
+        return true;
+    }
+
+    void BaseApp::threadPrepareApps()
+    {
+        while (true)
+        {
+            PrepareJob job;
+
+            {
+                std::unique_lock<std::mutex> lock(this->switch_mutex_);
+                this->prepare_cv_.wait(lock, [this] { return this->prepare_stop_ || this->prepare_job_pending_; });
+
+                if (this->prepare_stop_)
+                    return;
+
+                job = std::move(this->prepare_job_);
+                this->prepare_job_pending_ = false;
+            }
+
+            std::chrono::steady_clock::time_point start_tp = std::chrono::steady_clock::now();
+
+            // 初めて起動するアプリはここでDLLを読み込む
+            if (!this->loadApp(job.name, job.entry))
+            {
+                std::lock_guard<std::mutex> lock(this->switch_mutex_);
+                if (this->prepared_name_ == job.name && !this->prepare_job_pending_)
+                    this->prepared_name_.clear();
+                continue;
+            }
+
+            // このスレッドには描画先が無いため、init()での描画は画面外バッファに向け、切り替え時にパネルへ転送する
+            uint16_t width  = TLL_ENGINE(PanelManager)->getWidth();
+            uint16_t height = TLL_ENGINE(PanelManager)->getHeight();
+
+            std::unique_ptr<class AppInterface> app = this->createAppInstance(job.entry);
+            app->getTouchRegions().init(width, height);
+
+            Surface surface;
+            if (job.init_now)
+            {
+                surface.resize(width, height);
+
+                IPanelManager::setRenderTarget(&surface);
+                app->init();
+                IPanelManager::setRenderTarget(nullptr);
+            }
+
+            uint32_t init_us = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start_tp
+            ).count());
+
+            std::unique_lock<std::mutex> lock(this->switch_mutex_);
+
+            // 準備中に別のアプリ、または新しい版が要求された場合は使わない
+            if (this->prepared_name_ != job.name || this->app_list[job.name].handle != job.entry.handle)
+            {
+                lock.unlock();
+
+                if (job.init_now)
+                {
+                    IPanelManager::setRenderTarget(&surface);
+                    app->terminate();
+                    IPanelManager::setRenderTarget(nullptr);
+                }
+                continue;
+            }
+
+            this->prepared_handle_ = job.entry.handle;
+            this->prepared_app_ = std::move(app);
+            this->prepared_inited_ = job.init_now;
+            this->prepared_surface_ = std::move(surface);
+            this->prepare_init_us_ = init_us;
         }
+    }
 
-        if (app_name == "home")
+    void BaseApp::requestPrepare(const std::string& app_name)
+    {
+        std::lock_guard<std::mutex> lock(this->switch_mutex_);
+        this->prepare_request_ = app_name;
+    }
+
+    void BaseApp::applySwitch()
+    {
+        std::shared_ptr<void> next_handle;
+        std::unique_ptr<class AppInterface> next_app;
+        bool next_inited = false;
+        Surface next_surface;
+        std::string app_name;
+        std::chrono::steady_clock::time_point request_tp;
+        uint32_t init_us = 0;
+
+        // 他のスレッドから要求された準備はここで始める
+        std::string prepare_request;
         {
-            this->is_home_ = true;
-            is_found = true;
+            std::lock_guard<std::mutex> lock(this->switch_mutex_);
+            prepare_request.swap(this->prepare_request_);
+        }
+        if (!prepare_request.empty())
+            this->prepareApp(prepare_request);
 
+        {
+            std::lock_guard<std::mutex> lock(this->switch_mutex_);
+
+            if (this->pending_name_.empty())
+                return;
+
+            // 準備が終わるまでは起動中のアプリを動かし続ける
+            if (this->pending_name_ != "home")
+            {
+                // 後から別のアプリの準備が要求された場合はこの切り替えを取り消す
+                if (this->prepared_name_ != this->pending_name_)
+                {
+                    this->pending_name_.clear();
+                    return;
+                }
+
+                if (!this->prepared_app_)
+                    return;
+
+                next_handle = std::move(this->prepared_handle_);
+                next_app = std::move(this->prepared_app_);
+                next_inited = this->prepared_inited_;
+                next_surface = std::move(this->prepared_surface_);
+                this->prepared_inited_ = false;
+                this->prepared_name_.clear();
+                init_us = this->prepare_init_us_;
+            }
+
+            app_name = this->pending_name_;
+            request_tp = this->switch_request_tp_;
+            this->pending_name_.clear();
+        }
+
+        // 旧アプリの解放後に、どこからも参照されなくなったDLLを解放する
+        std::shared_ptr<void> prev_handle;
+        std::unique_ptr<class AppInterface> prev_app;
+
+        // 旧アプリを外してから終了させ、その後で新しいアプリを初期化する（外している間のイベントは配送されない）
+        {
+            std::lock_guard<std::mutex> lock(this->app_mutex_);
+
+            prev_handle = std::move(this->running_handle_);
+            prev_app = std::move(this->running_app);
+            this->running_name_.clear();
+        }
+
+        if (prev_app)
+            prev_app->terminate();
+        prev_app.reset();
+
+        // 旧アプリの画面を消してから新しいアプリを初期化し、init()で描いたものを残す
+        // （裏で初期化したアプリは、その際に画面外バッファへ描いたものを表示する）
+        if (next_inited)
+            TLL_ENGINE(PanelManager)->blit(0, 0, next_surface);
+        else
             clear();
+
+        if (next_app && !next_inited)
+        {
+            std::chrono::steady_clock::time_point init_tp = std::chrono::steady_clock::now();
+            next_app->init();
+
+            init_us += static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - init_tp
+            ).count());
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(this->app_mutex_);
+
+            this->running_handle_ = std::move(next_handle);
+            this->running_app = std::move(next_app);
+            this->running_name_ = this->running_app ? app_name : "";
+            this->is_home_ = !this->running_app;
+
+            // 切り替え前のタッチ・ジェスチャと一時停止、フレーム予算の監視状態は次のアプリに持ち越さない
+            this->gesture_.reset();
+            this->paused_ = false;
+            this->watchdog_.reset();
+        }
+
+        this->launcher_shown_ = LAUNCHER_DIRTY;
+
+        uint32_t switch_us = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - request_tp
+        ).count());
+
+        {
+            std::lock_guard<std::mutex> lock(this->switch_mutex_);
+
+            this->switch_stats_.count++;
+            this->switch_stats_.last_us      = switch_us;
+            this->switch_stats_.max_us       = std::max(this->switch_stats_.max_us, switch_us);
+            this->switch_stats_.last_init_us = init_us;
+
+            auto it = this->app_list.find(app_name);
+            if (it != this->app_list.end())
+                it->second.launches++;
+        }
+
+        std::cout << "[Switch] " << app_name << ": " << (switch_us / 1000.0) << " ms"
+                  << " (init " << (init_us / 1000.0) << " ms)" << std::endl;
+    }
+
+    SwitchStats BaseApp::getSwitchStats()
+    {
+        std::lock_guard<std::mutex> lock(this->switch_mutex_);
+
+        return this->switch_stats_;
+    }
+
+    bool BaseApp::openViewport(const std::string& app_name, const Viewport& requested)
+    {
+        // パネルからはみ出した部分は切り取る
+        int32_t left   = std::max<int32_t>(requested.x, 0);
+        int32_t top    = std::max<int32_t>(requested.y, 0);
+        int32_t right  = std::min<int32_t>(requested.x + requested.w, TLL_ENGINE(PanelManager)->getWidth());
+        int32_t bottom = std::min<int32_t>(requested.y + requested.h, TLL_ENGINE(PanelManager)->getHeight());
+
+        if (right <= left || bottom <= top)
+            return false;
+
+        Viewport viewport{ left, top, static_cast<uint16_t>(right - left), static_cast<uint16_t>(bottom - top) };
+
+        AppEntry entry;
+
+        {
+            std::lock_guard<std::mutex> lock(this->switch_mutex_);
+
+            auto it = this->app_list.find(app_name);
+            if (it == this->app_list.end())
+                return false;
+
+            entry = it->second;
+        }
+
+        // ビューポートは起動要求を受けたフレームで作成するため、未読み込みのDLLはここで読み込む
+        if (!this->loadApp(app_name, entry))
+            return false;
+
+        uint16_t layer = this->compositor_.addLayer(viewport);
+        if (layer == Compositor::NONE)
+        {
+            std::cerr << "[ERROR] Too many viewports: " << app_name << std::endl;
+            return false;
+        }
+
+        auto vp = std::make_unique<ViewportApp>();
+        vp->name   = app_name;
+        vp->handle = entry.handle;
+        vp->app    = this->createAppInstance(entry);
+        vp->layer  = layer;
+        vp->thread = std::thread(&BaseApp::threadViewportApp, this, vp.get());
+
+        std::lock_guard<std::mutex> lock(this->app_mutex_);
+        this->viewport_apps_.push_back(std::move(vp));
+
+        return true;
+    }
+
+    bool BaseApp::closeViewport(const std::string& app_name)
+    {
+        std::unique_ptr<ViewportApp> vp;
+
+        {
+            std::lock_guard<std::mutex> lock(this->app_mutex_);
+
+            auto it = std::find_if(this->viewport_apps_.begin(), this->viewport_apps_.end(), [&app_name](const auto& v)
+            {
+                return v->name == app_name;
+            });
+            if (it == this->viewport_apps_.end())
+                return false;
+
+            vp = std::move(*it);
+            this->viewport_apps_.erase(it);
+
+            for (auto owner = this->touch_owner_.begin(); owner != this->touch_owner_.end();)
+            {
+                if (owner->second == vp.get())
+                    owner = this->touch_owner_.erase(owner);
+                else
+                    ++owner;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(this->frame_mutex_);
+            vp->stop = true;
         }
+        this->frame_cv_.notify_all();
+
+        vp->thread.join();
+        this->compositor_.removeLayer(vp->layer);
+
+        // ビューポートの下になっていたホーム画面を描き直す
+        this->launcher_shown_ = LAUNCHER_DIRTY;
+
+        return true;
+    }
+
+    void BaseApp::threadViewportApp(ViewportApp* vp)
+    {
+        Viewport viewport = this->compositor_.getViewport(vp->layer);
+
+        // このスレッドからの描画は全てビューポートの画面外バッファに向ける
+        IPanelManager::setRenderTarget(this->compositor_.beginDraw(vp->layer));
+        vp->app->getTouchRegions().init(viewport.w, viewport.h);
+        vp->app->init();
+        this->compositor_.endDraw(vp->layer);
 
-        std::for_each(this->app_list.begin(), this->app_list.end(), [this, app_name, &is_found](std::unordered_map<std::string, void*>::value_type app)
+        uint64_t drawn_frame = 0;
+        std::vector<std::pair<ETouchEvent, TouchInfo>> events;
+
+        while (true)
         {
-            if (app.first == app_name)
             {
-                createApp* createAppFunc = (createApp*)(dlsym(this->app_list.find(app_name)->second, "create"));
-                std::unique_ptr<class AppInterface> app = createAppFunc();
-                this->running_app = std::move(app);
+                std::unique_lock<std::mutex> lock(this->frame_mutex_);
+                this->frame_cv_.wait(lock, [this, vp, drawn_frame] { return vp->stop || this->frame_count_ != drawn_frame; });
+                drawn_frame = this->frame_count_;
+            }
 
-                clear();
-                this->running_app->init();
+            if (vp->stop)
+                break;
 
-                this->is_home_ = false;
+            // 描画が遅れてもメインループは待たず、このアプリのフレームだけが落ちる
+            IPanelManager::setRenderTarget(this->compositor_.beginDraw(vp->layer));
 
-                is_found = true;
+            // タッチイベントもこのスレッドで配送し、コールバックからの描画をビューポートに向ける
+            {
+                std::lock_guard<std::mutex> lock(vp->event_mutex);
+                events.swap(vp->events);
             }
-        });
 
-        return is_found;
+            for (const auto& ev : events)
+            {
+                vp->app->getTouchRegions().dispatch(ev.first, ev.second);
+
+                switch (ev.first)
+                {
+                case ETouchEvent::TOUCHED:  vp->app->onTouched(ev.second);  break;
+                case ETouchEvent::MOVED:    vp->app->onMoved(ev.second);    break;
+                case ETouchEvent::RELEASED: vp->app->onReleased(ev.second); break;
+                }
+            }
+            events.clear();
+
+            // ビューポートのフレームは予算で監視しないため、期限は既定（無し）のまま番号と所要時間だけ更新する
+            FrameContext& ctx = vp->app->getFrameContext();
+            auto start = std::chrono::steady_clock::now();
+
+            vp->app->run();
+
+            ctx.frame++;
+            ctx.last_us = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+            this->compositor_.endDraw(vp->layer);
+        }
+
+        vp->app->terminate();
+        IPanelManager::setRenderTarget(nullptr);
+    }
+
+    bool BaseApp::dispatchViewport(ETouchEvent event, TouchInfo ti)
+    {
+        ViewportApp* vp = nullptr;
+
+        // タッチ開始時のビューポートが、離すまでそのタッチ点を捕捉する
+        auto owner = this->touch_owner_.find(ti.id);
+        if (owner != this->touch_owner_.end())
+        {
+            vp = owner->second;
+        }
+        else if (event == ETouchEvent::TOUCHED)
+        {
+            uint16_t layer = this->compositor_.hitTest(ti.raw_x, ti.raw_y);
+            for (auto& v : this->viewport_apps_)
+            {
+                if (layer != Compositor::NONE && v->layer == layer)
+                    vp = v.get();
+            }
+
+            if (vp)
+                this->touch_owner_[ti.id] = vp;
+        }
+
+        if (!vp)
+            return false;
+
+        if (event == ETouchEvent::RELEASED)
+            this->touch_owner_.erase(ti.id);
+
+        // ビューポート内の座標に変換する
+        Viewport viewport = this->compositor_.getViewport(vp->layer);
+        ti.x        -= viewport.x;
+        ti.y        -= viewport.y;
+        ti.raw_x    -= viewport.x;
+        ti.raw_y    -= viewport.y;
+        ti.smooth_x -= viewport.x;
+        ti.smooth_y -= viewport.y;
+
+        // アプリのコールバックはビューポートのスレッドで次のフレームの描画前に呼ぶ
+        {
+            std::lock_guard<std::mutex> lock(vp->event_mutex);
+            vp->events.emplace_back(event, ti);
+        }
+
+        this->delivered_num_++;
+        return true;
+    }
+
+    void BaseApp::composeViewports()
+    {
+        if (this->viewport_apps_.empty())
+            return;
+
+        this->compositor_.compose();
+
+        {
+            std::lock_guard<std::mutex> lock(this->frame_mutex_);
+            this->frame_count_++;
+        }
+        this->frame_cv_.notify_all();
+    }
+
+    void BaseApp::procOscMessage(const osc::ReceivedMessage& msg)
+    {
+        std::lock_guard<std::mutex> lock(this->app_mutex_);
+
+        if (!this->running_app)
+            return;
+
+        // ルートを登録していないアプリには従来通り全てのメッセージを渡す
+        if (this->running_app->getOscRoutes().empty())
+            this->running_app->procOscMessage(msg);
+        else
+            this->running_app->getOscRoutes().dispatch(msg);
     }
 
     uint32_t BaseApp::loadApps()
     {
-        uint32_t app_num = 0;
+        namespace fs = std::filesystem;
 
-        std::cout << "[Loaded applications]" << std::endl;
+        std::unordered_map<std::string, AppEntry> apps;
+        std::unordered_set<std::string> listed;
+        std::error_code ec;
 
-        auto dirs = std::filesystem::directory_iterator(std::filesystem::path("./app"));
-        for (auto& dir : dirs)
+        // 静的リンクされたアプリ（同じ名前のDLLより優先する）
+        for (const AppRegistry::Entry& registered : AppRegistry::entries())
         {
-            std::string path = dir.path().string();
+            AppEntry entry;
+            entry.create = registered.create;
+            entry.symbol = registered.name;    // 子プロセスではファクトリ関数を名前で探す
+            apps[registered.name] = entry;
+        }
 
-            // アプリファイルを検索し、ロードする
-            if (path.find(extention.c_str()) != std::string::npos)
+        // 一覧に記載されたアプリ（#から始まる行はコメント、アイコンが無い場合は"-"）
+        std::ifstream index(APP_INDEX);
+        std::string line;
+        while (std::getline(index, line))
+        {
+            if (line.empty() || line[0] == '#')
+                continue;
+
+            std::istringstream fields(line);
+            std::string app_name, library, icon;
+            AppEntry entry;
+            if (!(fields >> app_name >> library >> icon >> entry.symbol))
             {
-                std::string app_file_name = dir.path().stem().string();        // 拡張子を削除
-                std::string app_name = app_file_name.substr(3);                // 先頭の"lib"を削除
-                this->app_list[app_name] = dlopen(path.c_str(), RTLD_LAZY);    // DLLを読み込む
+                std::cerr << "[ERROR] Invalid app index: " << line << std::endl;
+                continue;
+            }
+            fields >> entry.launches;
 
-                std::cout << " - " << app_name << std::endl;
+            // 削除されたアプリは登録しない
+            entry.path = fs::absolute(fs::path("./app") / library, ec);
+            if (!fs::exists(entry.path, ec))
+                continue;
 
-                app_num++;    // 読み込んだアプリ数をカウント
-            }
+            entry.icon = (icon != "-") ? icon : "";
+            listed.insert(entry.path.filename().string());
+            apps.emplace(app_name, entry);
+        }
+
+        // 一覧に無いアプリはファイル名から登録する
+        for (auto& dir : fs::directory_iterator(fs::path("./app"), ec))
+        {
+            std::string app_name;
+            if (listed.count(dir.path().filename().string()) || !appNameFromFile(dir.path(), app_name))
+                continue;
+
+            AppEntry entry;
+            entry.path = fs::absolute(dir.path(), ec);
+            apps.emplace(app_name, entry);
         }
+
+        std::cout << "[Registered applications]" << std::endl;
+        for (auto& [app_name, entry] : apps)
+            std::cout << " - " << app_name << (entry.path.empty() ? " (static)" : "") << std::endl;
         std::cout << std::endl;
-        
-        return app_num;
+
+        std::lock_guard<std::mutex> lock(this->switch_mutex_);
+        this->app_list = std::move(apps);
+
+        return static_cast<uint32_t>(this->app_list.size());
+    }
+
+    void BaseApp::saveAppIndex()
+    {
+        namespace fs = std::filesystem;
+
+        std::vector<std::pair<std::string, AppEntry>> apps;
+
+        {
+            std::lock_guard<std::mutex> lock(this->switch_mutex_);
+            // 静的リンクされたアプリはファイルが無いため記録しない
+            for (auto& app : this->app_list)
+            {
+                if (!app.second.path.empty())
+                    apps.push_back(app);
+            }
+        }
+
+        std::sort(apps.begin(), apps.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        // 書き込み途中で終了しても一覧が壊れないよう、別名で書き込んでから置き換える
+        std::string tmp_path = std::string(APP_INDEX) + ".tmp";
+        std::ofstream index(tmp_path);
+        index << "# name\tlibrary\ticon\tsymbol\tlaunches" << std::endl;
+        for (auto& [app_name, entry] : apps)
+        {
+            index << app_name                                    << '\t'
+                  << entry.path.filename().string()              << '\t'
+                  << (!entry.icon.empty() ? entry.icon : "-")    << '\t'
+                  << entry.symbol                                << '\t'
+                  << entry.launches                              << std::endl;
+        }
+        index.close();
+
+        std::error_code ec;
+        if (!index)
+        {
+            std::cerr << "[ERROR] Failed to write " << APP_INDEX << std::endl;
+            fs::remove(tmp_path, ec);
+            return;
+        }
+
+        fs::rename(tmp_path, APP_INDEX, ec);
+    }
+
+    bool BaseApp::loadApp(const std::string& app_name, AppEntry& entry)
+    {
+        // 静的リンクされたアプリ・読み込み済みのアプリはそのまま使い、子プロセスで動かす場合は子プロセス側で読み込む
+        if (entry.create || this->isolate_apps_)
+            return true;
+
+        AppEntry loaded = entry;
+        if (!openApp(loaded))
+            return false;
+
+        std::lock_guard<std::mutex> lock(this->switch_mutex_);
+
+        // 別のスレッドが先に読み込んだ（または新しい版に更新された）場合はそちらを使う
+        auto it = this->app_list.find(app_name);
+        if (it == this->app_list.end())
+        {
+            entry = loaded;
+            return true;
+        }
+
+        if (!it->second.create)
+        {
+            it->second.handle = loaded.handle;
+            it->second.create = loaded.create;
+        }
+        entry = it->second;
+
+        return true;
+    }
+
+    void BaseApp::threadPreloadApps()
+    {
+        std::vector<std::pair<uint32_t, std::string>> ranking;
+
+        {
+            std::lock_guard<std::mutex> lock(this->switch_mutex_);
+
+            for (auto& [app_name, entry] : this->app_list)
+            {
+                if (entry.launches > 0 && !entry.create)
+                    ranking.emplace_back(entry.launches, app_name);
+            }
+        }
+
+        std::sort(ranking.begin(), ranking.end(), std::greater<>());
+        if (ranking.size() > this->preload_num_)
+            ranking.resize(this->preload_num_);
+
+        for (auto& [launches, app_name] : ranking)
+        {
+            if (TLL_ENGINE(EventHandler)->getQuitFlag())
+                break;
+
+            AppEntry entry;
+
+            {
+                std::lock_guard<std::mutex> lock(this->switch_mutex_);
+
+                auto it = this->app_list.find(app_name);
+                if (it == this->app_list.end())
+                    continue;
+
+                entry = it->second;
+            }
+
+            if (!entry.create && !this->isolate_apps_ && this->loadApp(app_name, entry))
+                std::cout << "[Preload] " << app_name << std::endl;
+        }
+    }
+
+    bool BaseApp::openApp(AppEntry& entry)
+    {
+        namespace fs = std::filesystem;
+
+        static std::atomic<uint32_t> version{0};
+        static std::once_flag cleanup;
+
+        const fs::path& path = entry.path;
+
+        // 同じパスのDLLは読み込み済みのものが返されるため、別名のコピーを作ってから読み込む
+        std::error_code ec;
+        fs::path dir = fs::temp_directory_path(ec) / "tll_apps";
+        fs::create_directories(dir, ec);
+
+        std::call_once(cleanup, removeStaleCopies, dir);
+
+        // 他のプロセス（別のランタイムや分離実行の子）のコピーと衝突しないよう、PIDを含めた上でmkstempで一意にする
+        std::string name = (dir / path.stem()).string() + "." + std::to_string(getpid()) + "."
+            + std::to_string(++version) + ".XXXXXX" + extention;
+
+        int fd = mkostemps(&name[0], static_cast<int>(extention.size()), O_CLOEXEC);
+        if (fd < 0)
+        {
+            std::cerr << "[ERROR] Failed to create a copy of " << path << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        close(fd);
+
+        fs::path versioned = name;
+        fs::copy_file(path, versioned, fs::copy_options::overwrite_existing, ec);
+        if (ec)
+        {
+            std::cerr << "[ERROR] Failed to copy " << path << ": " << ec.message() << std::endl;
+            fs::remove(versioned, ec);
+            return false;
+        }
+
+        // コピーはDLLを解放するまで残す（削除したファイルのinodeが再利用されると、別のDLLが読み込み済みと判定されうるため）
+        void* handle = dlopen(versioned.c_str(), RTLD_LAZY);    // DLLを読み込む
+
+        if (!handle)
+        {
+            std::cerr << "[ERROR] " << dlerror() << std::endl;
+            fs::remove(versioned, ec);
+            return false;
+        }
+
+        // 切り替えのたびに探さないよう、ファクトリ関数をここで解決しておく
+        createApp* createAppFunc = (createApp*)(dlsym(handle, entry.symbol.c_str()));
+        if (!createAppFunc)
+        {
+            std::cerr << "[ERROR] " << path << ": " << entry.symbol << "() not found" << std::endl;
+            dlclose(handle);
+            fs::remove(versioned, ec);
+            return false;
+        }
+
+        entry.handle = std::shared_ptr<void>(handle, [versioned](void* h) {
+            dlclose(h);
+
+            std::error_code ec;
+            fs::remove(versioned, ec);
+        });
+        entry.create = createAppFunc;
+
+        return true;
+    }
+
+    std::unique_ptr<class AppInterface> BaseApp::createAppInstance(const AppEntry& entry)
+    {
+        if (this->isolate_apps_ || entry.demoted)
+            return std::make_unique<RemoteApp>(entry.path.string(), entry.symbol);
+
+        return entry.create();
+    }
+
+    void BaseApp::threadWatchApps()
+    {
+        int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0)
+            return;
+
+        // 書き込み完了、または別名からの置き換え（mv）で更新を検知する
+        if (inotify_add_watch(fd, "./app", IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+        {
+            close(fd);
+            return;
+        }
+
+        alignas(struct inotify_event) char buf[4096];
+
+        while (!TLL_ENGINE(EventHandler)->getQuitFlag())
+        {
+            struct pollfd pfd = { fd, POLLIN, 0 };
+            if (poll(&pfd, 1, 200) <= 0)
+                continue;
+
+            ssize_t len = read(fd, buf, sizeof(buf));
+            if (len <= 0)
+                continue;
+
+            for (char* p = buf; p < buf + len; p += sizeof(struct inotify_event) + reinterpret_cast<struct inotify_event*>(p)->len)
+            {
+                struct inotify_event* ev = reinterpret_cast<struct inotify_event*>(p);
+                if (ev->len == 0)
+                    continue;
+
+                std::error_code ec;
+                std::filesystem::path path = std::filesystem::absolute(std::filesystem::path("./app") / ev->name, ec);
+                if (path.extension() != extention)
+                    continue;
+
+                // 登録済みのアプリはDLLのパスで探し、一覧の名前と設定を引き継ぐ
+                std::string app_name;
+                AppEntry entry;
+                {
+                    std::lock_guard<std::mutex> lock(this->switch_mutex_);
+
+                    auto it = std::find_if(this->app_list.begin(), this->app_list.end(), [&path](const auto& app)
+                    {
+                        return app.second.path == path;
+                    });
+
+                    if (it != this->app_list.end())
+                    {
+                        app_name = it->first;
+                        entry = it->second;
+                    }
+                    else if (!appNameFromFile(path, app_name))
+                        continue;
+                    else if (this->app_list.count(app_name))
+                    {
+                        // 静的リンクされたアプリや一覧のアプリを、同じ名前の新しいDLLで置き換えない
+                        std::cerr << "[ERROR] " << path.filename() << ": " << app_name << " is already registered" << std::endl;
+                        continue;
+                    }
+                }
+
+                bool was_loaded = static_cast<bool>(entry.handle);
+                entry.handle.reset();
+                entry.create = nullptr;
+                entry.path = path;
+
+                // 読み込み済みのアプリはこのスレッドで新しい版を読み込み、登録はメインループで行う
+                // （未読み込みのアプリは次の起動時に読み込まれる）
+                if (was_loaded && !openApp(entry))
+                    continue;
+
+                std::lock_guard<std::mutex> lock(this->reload_mutex_);
+                this->reloaded_apps_.emplace_back(app_name, std::move(entry));
+            }
+        }
+
+        close(fd);
+    }
+
+    void BaseApp::applyReloads()
+    {
+        std::vector<std::pair<std::string, AppEntry>> reloaded;
+
+        {
+            std::lock_guard<std::mutex> lock(this->reload_mutex_);
+            if (this->reloaded_apps_.empty())
+                return;
+
+            reloaded.swap(this->reloaded_apps_);
+        }
+
+        for (auto& [app_name, entry] : reloaded)
+        {
+            std::shared_ptr<void> stale_handle;
+            std::unique_ptr<class AppInterface> stale;
+            bool stale_inited = false;
+            bool is_pending;
+
+            {
+                std::lock_guard<std::mutex> lock(this->switch_mutex_);
+
+                // 起動回数は読み込み中に増えている場合がある
+                entry.launches = this->app_list[app_name].launches;
+                this->app_list[app_name] = entry;
+                is_pending = (this->pending_name_ == app_name);
+
+                // 旧版で準備したアプリは使わない（準備中のものは完了時に破棄される）
+                if (this->prepared_name_ == app_name)
+                {
+                    stale_handle = std::move(this->prepared_handle_);
+                    stale = std::move(this->prepared_app_);
+                    stale_inited = this->prepared_inited_;
+                    this->prepared_inited_ = false;
+                    this->prepared_name_.clear();
+                }
+            }
+
+            if (stale && stale_inited)
+                stale->terminate();
+            stale.reset();
+
+            std::cout << "[Reload] " << app_name << std::endl;
+
+            // 起動中（切り替え中）であれば、新しい版を裏で初期化してから入れ替える
+            if (this->running_name_ == app_name || is_pending)
+                this->switchApp(app_name);
+        }
     }
 
 }
 
 int main(int argc, char** argv)
 {
-    if (argc > 1)
+    // 子プロセスとしてアプリを動かす場合（RemoteAppから起動される）
+    if (argc == 7 && strcmp(argv[1], "--app-host") == 0)
+        return tll::runAppHost(argv[2], argv[3], argv[4], std::atoi(argv[5]), std::atoi(argv[6]));
+
+    // タッチ位置予測の先読み時間[ms]（0の場合は予測しない）
+    int32_t predict_ms = 0;
+
+    // イベント配送数を毎秒表示するか
+    bool count_events = false;
+
+    // 赤外線センサ画像の受信先（例: tcp://localhost:44102）
+    std::string ir_endpoint;
+
+    // アプリをそれぞれ子プロセスで動かすか
+    bool isolate_apps = false;
+
+    // 最初のフレームの表示後に裏で読み込むアプリ数
+    int32_t preload_num = 2;
+
+    // アプリのrun()に使える時間[ms]
+    double budget_ms = 16.0;
+
+    for (int i = 1; i < argc; i++)
     {
-        if (strcmp(argv[1], "--without-osc") == 0) with_osc = false;
+        if (strcmp(argv[i], "--without-osc") == 0) with_osc = false;
+        else if (strcmp(argv[i], "--predict") == 0 && i + 1 < argc) predict_ms = std::atoi(argv[++i]);
+        else if (strcmp(argv[i], "--count-events") == 0) count_events = true;
+        else if (strcmp(argv[i], "--ir-sensor") == 0 && i + 1 < argc) ir_endpoint = argv[++i];
+        else if (strcmp(argv[i], "--isolate") == 0) isolate_apps = true;
+        else if (strcmp(argv[i], "--preload") == 0 && i + 1 < argc) preload_num = std::atoi(argv[++i]);
+        else if (strcmp(argv[i], "--frame-budget") == 0 && i + 1 < argc) budget_ms = std::atof(argv[++i]);
+        else if (strcmp(argv[i], "--viewport") == 0 && i + 1 < argc)
+        {
+            // 例: --viewport Clock:0,0,64,8
+            char app_name[48];
+            int x, y, w, h;
+            if (sscanf(argv[++i], "%47[^:]:%d,%d,%d,%d", app_name, &x, &y, &w, &h) == 5)
+                tll::tllEngine::get()->getComponent<tll::ICommandBus>()->postOpenViewport(app_name, x, y, w, h);
+            else
+                std::cerr << "[ERROR] Invalid viewport: " << argv[i] << std::endl;
+        }
     }
 
     tll::BaseApp* base_app = new tll::BaseApp();
+    base_app->setEventCount(count_events);
+    base_app->setIrSensor(ir_endpoint);
+    base_app->setIsolateApps(isolate_apps);
+    base_app->setPreloadApps(static_cast<uint32_t>(std::max(preload_num, 0)));
+    base_app->getFrameWatchdog().getConfig().budget_us = static_cast<uint32_t>(std::max(budget_ms, 1.0) * 1000.0);
+
+    if (predict_ms > 0)
+    {
+        base_app->getTouchPredictor().getConfig().enabled   = true;
+        base_app->getTouchPredictor().getConfig().lookahead = static_cast<uint32_t>(predict_ms);
+    }
 
     if (with_osc)
     {
-        std::thread thread_osc(tll::runOscReceiveThread, base_app);
-        thread_osc.detach();
+        tll::startOscReceive(base_app);
     }
 
     base_app->run();
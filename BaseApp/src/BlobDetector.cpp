@@ -0,0 +1,372 @@
+/**
+ * @file    BlobDetector.cpp
+ * @brief   IR sensor frame blob detection
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#include "BlobDetector.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "tllEngine.hpp"
+#include "Common.hpp"
+#include "Event.hpp"
+#include "PanelManager.hpp"
+
+#include <zmq.hpp>
+
+namespace tll
+{
+
+    BlobDetector::BlobDetector() noexcept
+        : width_(0)
+        , height_(0)
+        , learned_frames_(0)
+        , next_id_(1)
+    {
+    }
+
+    void BlobDetector::init(uint16_t width, uint16_t height)
+    {
+        this->width_  = width;
+        this->height_ = height;
+
+        size_t size = width * height;
+
+        this->background_.assign(size, 0);
+        this->background_sum_.assign(size, 0);
+        this->mask_.assign(size, 0);
+        this->labels_.assign(size, 0);
+
+        // 4近傍で連結しないピクセルは市松模様で高々半数なので、ラベル数の上限は size / 2 + 1
+        this->parent_.assign(size / 2 + 2, 0);
+        this->components_.assign(size / 2 + 2, Component());
+
+        this->detected_.reserve(64);
+        this->blobs_.reserve(64);
+        this->removed_ids_.reserve(64);
+        this->matched_.reserve(64);
+
+        this->resetBackground();
+    }
+
+    void BlobDetector::resetBackground()
+    {
+        std::fill(this->background_sum_.begin(), this->background_sum_.end(), 0);
+        this->learned_frames_ = 0;
+
+        // 追跡中だった領域は消えたものとして通知する（学習中もprocess()の結果に関わらず通知される）
+        for (auto& blob : this->blobs_)
+            this->removed_ids_.push_back(blob.id);
+        this->blobs_.clear();
+    }
+
+    bool BlobDetector::process(const uint8_t* frame)
+    {
+        size_t size = this->width_ * this->height_;
+
+        // 起動直後の数フレームを平均して背景とする
+        if (this->learned_frames_ < this->background_frames)
+        {
+            for (size_t i = 0; i < size; i++)
+                this->background_sum_[i] += frame[i];
+
+            this->learned_frames_++;
+
+            if (this->learned_frames_ == this->background_frames)
+            {
+                for (size_t i = 0; i < size; i++)
+                    this->background_[i] = static_cast<uint8_t>(this->background_sum_[i] / this->background_frames);
+            }
+
+            return false;
+        }
+
+        this->subtractBackground(frame);
+        this->labelComponents();
+        this->track();
+
+        return true;
+    }
+
+    void BlobDetector::subtractBackground(const uint8_t* frame)
+    {
+        const uint8_t* bg = this->background_.data();
+        uint8_t* mask = this->mask_.data();
+
+        size_t size = this->width_ * this->height_;
+        size_t i = 0;
+
+        // 飽和減算した差分を閾値と比較し、16ピクセルずつマスクを作る
+        #if defined(__ARM_NEON) || defined(__ARM_NEON__)
+        uint8x16_t thr = vdupq_n_u8(this->threshold);
+        for (; i + 16 <= size; i += 16)
+        {
+            uint8x16_t diff = vqsubq_u8(vld1q_u8(frame + i), vld1q_u8(bg + i));
+            vst1q_u8(mask + i, vcgtq_u8(diff, thr));
+        }
+        #elif defined(__SSE2__)
+        __m128i thr  = _mm_set1_epi8(static_cast<char>(this->threshold));
+        __m128i zero = _mm_setzero_si128();
+        __m128i ones = _mm_set1_epi8(static_cast<char>(0xFF));
+        for (; i + 16 <= size; i += 16)
+        {
+            __m128i f    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(frame + i));
+            __m128i b    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bg + i));
+            __m128i diff = _mm_subs_epu8(f, b);
+
+            // diff <= thr の場合に saturate(diff - thr) == 0 となるので、それを反転する
+            __m128i le   = _mm_cmpeq_epi8(_mm_subs_epu8(diff, thr), zero);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(mask + i), _mm_xor_si128(le, ones));
+        }
+        #endif
+
+        for (; i < size; i++)
+        {
+            uint8_t diff = (frame[i] > bg[i]) ? frame[i] - bg[i] : 0;
+            mask[i] = (diff > this->threshold) ? 0xFF : 0x00;
+        }
+    }
+
+    uint32_t BlobDetector::findRoot(uint32_t label)
+    {
+        while (this->parent_[label] != label)
+        {
+            this->parent_[label] = this->parent_[this->parent_[label]];
+            label = this->parent_[label];
+        }
+
+        return label;
+    }
+
+    void BlobDetector::labelComponents()
+    {
+        const int32_t w = this->width_;
+        const int32_t h = this->height_;
+
+        uint32_t next_label = 1;
+
+        // 1パス目: 上・左の近傍からラベルを伝搬し、衝突したラベルを併合する
+        for (int32_t y = 0; y < h; y++)
+        {
+            for (int32_t x = 0; x < w; x++)
+            {
+                int32_t i = y * w + x;
+
+                if (!this->mask_[i])
+                {
+                    this->labels_[i] = 0;
+                    continue;
+                }
+
+                uint32_t left = (x > 0) ? this->labels_[i - 1] : 0;
+                uint32_t up   = (y > 0) ? this->labels_[i - w] : 0;
+
+                if (left == 0 && up == 0)
+                {
+                    if (next_label >= this->parent_.size())
+                    {
+                        this->labels_[i] = 0;
+                        continue;
+                    }
+
+                    this->parent_[next_label] = next_label;
+                    this->labels_[i] = next_label++;
+                }
+                else if (left == 0 || up == 0)
+                {
+                    this->labels_[i] = left | up;
+                }
+                else
+                {
+                    uint32_t rl = this->findRoot(left);
+                    uint32_t ru = this->findRoot(up);
+                    uint32_t root = std::min(rl, ru);
+
+                    this->parent_[rl] = root;
+                    this->parent_[ru] = root;
+                    this->labels_[i] = root;
+                }
+            }
+        }
+
+        for (uint32_t l = 1; l < next_label; l++)
+        {
+            this->components_[l] = Component{ w, h, -1, -1, 0, 0, 0 };
+        }
+
+        // 2パス目: 代表ラベルごとに外接矩形・重心・面積を集計する
+        for (int32_t y = 0; y < h; y++)
+        {
+            for (int32_t x = 0; x < w; x++)
+            {
+                uint32_t label = this->labels_[y * w + x];
+                if (label == 0)
+                    continue;
+
+                Component& c = this->components_[this->findRoot(label)];
+                c.min_x = std::min(c.min_x, x);
+                c.min_y = std::min(c.min_y, y);
+                c.max_x = std::max(c.max_x, x);
+                c.max_y = std::max(c.max_y, y);
+                c.sum_x += x;
+                c.sum_y += y;
+                c.area++;
+            }
+        }
+
+        this->detected_.clear();
+        for (uint32_t l = 1; l < next_label; l++)
+        {
+            const Component& c = this->components_[l];
+            if (this->parent_[l] != l || c.area < this->min_area)
+                continue;
+
+            this->detected_.push_back(DetectedBlob{
+                0,
+                c.min_x,
+                c.min_y,
+                c.max_x - c.min_x + 1,
+                c.max_y - c.min_y + 1,
+                static_cast<int32_t>(c.sum_x / c.area),
+                static_cast<int32_t>(c.sum_y / c.area),
+                c.area
+            });
+        }
+    }
+
+    void BlobDetector::track()
+    {
+        this->matched_.assign(this->blobs_.size(), false);
+
+        // 前フレームの領域のうち、重心が最も近いものと同じIDを引き継ぐ
+        for (auto& blob : this->detected_)
+        {
+            int32_t best = -1;
+            int32_t best_dist = this->max_distance * this->max_distance;
+
+            for (size_t j = 0; j < this->blobs_.size(); j++)
+            {
+                if (this->matched_[j])
+                    continue;
+
+                int32_t dx = blob.cx - this->blobs_[j].cx;
+                int32_t dy = blob.cy - this->blobs_[j].cy;
+                int32_t dist = dx * dx + dy * dy;
+
+                if (dist <= best_dist)
+                {
+                    best = static_cast<int32_t>(j);
+                    best_dist = dist;
+                }
+            }
+
+            if (best >= 0)
+            {
+                blob.id = this->blobs_[best].id;
+                this->matched_[best] = true;
+            }
+            else
+            {
+                blob.id = this->next_id_++;
+            }
+        }
+
+        for (size_t j = 0; j < this->blobs_.size(); j++)
+        {
+            if (!this->matched_[j])
+                this->removed_ids_.push_back(this->blobs_[j].id);
+        }
+
+        this->blobs_.swap(this->detected_);
+    }
+
+    void threadReceiveIrFrame(std::string endpoint)
+    {
+        zmq::context_t ctx;
+        zmq::socket_t sub(ctx, zmq::socket_type::sub);
+        sub.connect(endpoint);
+        sub.set(zmq::sockopt::subscribe, "ir");
+        sub.set(zmq::sockopt::rcvtimeo, 100);
+
+        BlobDetector detector;
+
+        uint16_t panel_width  = TLL_ENGINE(PanelManager)->getWidth();
+        uint16_t panel_height = TLL_ENGINE(PanelManager)->getHeight();
+
+        printLog("Start receiving IR frames");
+        while (!TLL_ENGINE(EventHandler)->getQuitFlag())
+        {
+            zmq::message_t topic;
+            zmq::message_t msg;
+
+            if (!sub.recv(topic, zmq::recv_flags::none))
+                continue;
+            if (!sub.recv(msg, zmq::recv_flags::none))
+                continue;
+
+            // フレーム形式: 幅(uint16) 高さ(uint16) 輝度(uint8 x 幅 x 高さ)
+            if (msg.size() < 4)
+                continue;
+
+            uint16_t width, height;
+            std::memcpy(&width,  msg.data<uint8_t>(),     sizeof(width));
+            std::memcpy(&height, msg.data<uint8_t>() + 2, sizeof(height));
+
+            if (msg.size() != 4 + static_cast<size_t>(width) * height)
+            {
+                std::cerr << "[ERROR] Invalid IR frame size" << std::endl;
+                continue;
+            }
+
+            if (width != detector.getWidth() || height != detector.getHeight())
+                detector.init(width, height);
+
+            bool tracked = detector.process(msg.data<uint8_t>() + 4);
+
+            // OSC受信スレッドやメインループと同じTuioServerを操作するため、イベントハンドラのロックを取る
+            std::lock_guard<std::mutex> lock(TLL_ENGINE(EventHandler)->getEventMutex());
+
+            // 背景の学習し直しで消えた領域も、学習中のうちに削除を通知して残らないようにする
+            for (uint32_t id : detector.getRemovedIds())
+            {
+                TLL_ENGINE(EventHandler)->removeTouchedPoint(id);
+                TLL_ENGINE(EventHandler)->removeTouchedBlob(id);
+            }
+            detector.clearRemovedIds();
+
+            if (!tracked)
+                continue;
+
+            // センサ座標をパネル座標に変換してイベントハンドラに渡す
+            auto toPanelX = [&](int32_t v) { return v * panel_width  / width;  };
+            auto toPanelY = [&](int32_t v) { return v * panel_height / height; };
+
+            for (const auto& blob : detector.getBlobs())
+            {
+                TLL_ENGINE(EventHandler)->addTouchedPoint(blob.id, toPanelX(blob.cx), toPanelY(blob.cy));
+                TLL_ENGINE(EventHandler)->addTouchedBlob(
+                    blob.id,
+                    toPanelX(blob.x),
+                    toPanelY(blob.y),
+                    std::max(toPanelX(blob.w), 1),
+                    std::max(toPanelY(blob.h), 1)
+                );
+            }
+        }
+
+        sub.close();
+    }
+
+}
@@ -0,0 +1,141 @@
+/**
+ * @file    CommandBus.cpp
+ * @brief   Lock-free command queue applied at frame boundaries
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#include "CommandBus.hpp"
+
+#include <cstring>
+
+#include "Common.hpp"
+
+namespace tll
+{
+
+    ICommandBus* ICommandBus::create()
+    {
+        return new CommandBus();
+    }
+
+    namespace
+    {
+        // アプリ名付きのコマンドを作成する（長すぎる場合はfalse）
+        bool makeAppCommand(ECommand type, const std::string& app_name, Command& cmd)
+        {
+            cmd = Command{ type, 0, {}, {} };
+
+            if (app_name.size() >= sizeof(cmd.app_name))
+                return false;
+
+            std::memcpy(cmd.app_name, app_name.c_str(), app_name.size() + 1);
+            return true;
+        }
+    }
+
+    bool ICommandBus::postSwitchApp(const std::string& app_name)
+    {
+        Command cmd;
+        return makeAppCommand(ECommand::SWITCH_APP, app_name, cmd) && this->post(cmd);
+    }
+
+    bool ICommandBus::postPause(bool pause)
+    {
+        return this->post(Command{ pause ? ECommand::PAUSE : ECommand::RESUME, 0, {}, {} });
+    }
+
+    bool ICommandBus::postTogglePause()
+    {
+        return this->post(Command{ ECommand::TOGGLE_PAUSE, 0, {}, {} });
+    }
+
+    bool ICommandBus::postBrightness(uint8_t brightness)
+    {
+        return this->post(Command{ ECommand::SET_BRIGHTNESS, brightness, {}, {} });
+    }
+
+    bool ICommandBus::postOpenViewport(const std::string& app_name, int16_t x, int16_t y, int16_t w, int16_t h)
+    {
+        Command cmd;
+        if (!makeAppCommand(ECommand::OPEN_VIEWPORT, app_name, cmd))
+            return false;
+
+        cmd.rect[0] = x;
+        cmd.rect[1] = y;
+        cmd.rect[2] = w;
+        cmd.rect[3] = h;
+
+        return this->post(cmd);
+    }
+
+    bool ICommandBus::postCloseViewport(const std::string& app_name)
+    {
+        Command cmd;
+        return makeAppCommand(ECommand::CLOSE_VIEWPORT, app_name, cmd) && this->post(cmd);
+    }
+
+    CommandBus::CommandBus() noexcept
+        : tail_(0)
+        , head_(0)
+    {
+        for (size_t i = 0; i < CAPACITY; i++)
+            this->cells_[i].seq.store(i, std::memory_order_relaxed);
+
+        printLog("Create Command bus");
+    }
+
+    CommandBus::~CommandBus() noexcept
+    {
+        printLog("Destroy Command bus");
+    }
+
+    bool CommandBus::post(const Command& cmd)
+    {
+        size_t pos = this->tail_.load(std::memory_order_relaxed);
+        Cell* cell;
+
+        // 空いている要素の位置を確保する
+        while (true)
+        {
+            cell = &this->cells_[pos & (CAPACITY - 1)];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+            if (diff == 0)
+            {
+                if (this->tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                // 受信側がまだ読み出していない
+                return false;
+            }
+            else
+            {
+                pos = this->tail_.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->cmd = cmd;
+        cell->seq.store(pos + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    bool CommandBus::poll(Command& cmd)
+    {
+        Cell* cell = &this->cells_[this->head_ & (CAPACITY - 1)];
+
+        if (cell->seq.load(std::memory_order_acquire) != this->head_ + 1)
+            return false;
+
+        cmd = cell->cmd;
+        cell->seq.store(this->head_ + CAPACITY, std::memory_order_release);
+        this->head_++;
+
+        return true;
+    }
+
+}
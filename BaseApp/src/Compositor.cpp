@@ -0,0 +1,124 @@
+/**
+ * @file    Compositor.cpp
+ * @brief   Viewport surface composition
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#include "Compositor.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "tllEngine.hpp"
+
+namespace tll
+{
+
+    uint16_t Compositor::addLayer(const Viewport& viewport)
+    {
+        auto layer = std::make_unique<Layer>();
+        layer->has_frame = false;
+        layer->viewport  = viewport;
+        layer->front.resize(viewport.w, viewport.h);
+        layer->back.resize(viewport.w, viewport.h);
+
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        uint16_t id;
+        if (!this->free_ids_.empty())
+        {
+            id = this->free_ids_.back();
+            this->free_ids_.pop_back();
+            this->layers_[id - 1] = std::move(layer);
+        }
+        else if (this->layers_.size() < UINT16_MAX)
+        {
+            this->layers_.push_back(std::move(layer));
+            id = static_cast<uint16_t>(this->layers_.size());
+        }
+        else
+            return NONE;
+
+        this->order_.push_back(id);
+        return id;
+    }
+
+    void Compositor::removeLayer(uint16_t id)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        if (id == NONE || id > this->layers_.size() || !this->layers_[id - 1])
+            return;
+
+        this->layers_[id - 1].reset();
+        this->free_ids_.push_back(id);
+        this->order_.erase(std::remove(this->order_.begin(), this->order_.end(), id), this->order_.end());
+    }
+
+    Surface* Compositor::beginDraw(uint16_t id)
+    {
+        Layer* layer = this->find(id);
+        return layer ? &layer->back : nullptr;
+    }
+
+    void Compositor::endDraw(uint16_t id)
+    {
+        Layer* layer = this->find(id);
+        if (!layer)
+            return;
+
+        std::lock_guard<std::mutex> lock(layer->mutex);
+
+        // 描画し終えたバッファを前面に回し、前のフレームの内容を引き継いで次の描画を始める
+        std::swap(layer->front, layer->back);
+        layer->back.pixels = layer->front.pixels;
+        layer->has_frame = true;
+    }
+
+    void Compositor::compose()
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        for (uint16_t id : this->order_)
+        {
+            Layer* layer = this->layers_[id - 1].get();
+            if (!layer->has_frame)
+                continue;
+
+            std::lock_guard<std::mutex> layer_lock(layer->mutex);
+            TLL_ENGINE(PanelManager)->blit(layer->viewport.x, layer->viewport.y, layer->front);
+        }
+    }
+
+    uint16_t Compositor::hitTest(int32_t x, int32_t y)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        for (auto it = this->order_.rbegin(); it != this->order_.rend(); ++it)
+        {
+            const Viewport& v = this->layers_[*it - 1]->viewport;
+            if (x >= v.x && y >= v.y && x < v.x + v.w && y < v.y + v.h)
+                return *it;
+        }
+
+        return NONE;
+    }
+
+    Viewport Compositor::getViewport(uint16_t id)
+    {
+        Layer* layer = this->find(id);
+        return layer ? layer->viewport : Viewport{ 0, 0, 0, 0 };
+    }
+
+    Compositor::Layer* Compositor::find(uint16_t id)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        if (id == NONE || id > this->layers_.size())
+            return nullptr;
+
+        return this->layers_[id - 1].get();
+    }
+
+}
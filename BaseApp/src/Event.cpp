@@ -7,20 +7,52 @@
 
 #include "Event.hpp"
 
+#include <cerrno>
 #include <cstdio>
-#include <fcntl.h>
 #include <iostream>
-#include <termios.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <unistd.h>
 
+#include "CommandBus.hpp"
 #include "Common.hpp"
-#include "OscHandler.hpp"
+#include "LatencyTracer.hpp"
 #include "PanelManager.hpp"
+#include "UdpReactor.hpp"
 
 #include "TuioTime.h"
 
 namespace tll
 {
+    namespace
+    {
+        // 終了キー（ESC）
+        constexpr int QUIT_KEY = 27;
+
+        /* キーと制御コマンドの対応 */
+        struct KeyBinding
+        {
+            int key;
+            ECommand command;
+            int32_t value;
+            const char* app_name;
+        };
+
+        constexpr KeyBinding KEY_BINDINGS[] = {
+            { '1', ECommand::SWITCH_APP,     0,   "home"              },
+            { '2', ECommand::SWITCH_APP,     0,   "TouchPoints"       },
+            { '3', ECommand::SWITCH_APP,     0,   "Rain"              },
+            { '4', ECommand::SWITCH_APP,     0,   "MultiTouchLine"    },
+            { '5', ECommand::SWITCH_APP,     0,   "CockroachShooting" },
+            { '6', ECommand::SWITCH_APP,     0,   "Theremin"          },
+            { '7', ECommand::SWITCH_APP,     0,   "MusicVisualizer"   },
+            { '8', ECommand::SWITCH_APP,     0,   "ADIR01P_Light"     },
+            { 'p', ECommand::TOGGLE_PAUSE,   0,   nullptr             },
+            { '[', ECommand::SET_BRIGHTNESS, 64,  nullptr             },
+            { ']', ECommand::SET_BRIGHTNESS, 255, nullptr             },
+        };
+    }
+
     IEventHandler* IEventHandler::create()
     {
         return new EventHandlerTuio();
@@ -33,6 +65,20 @@ namespace tll
 
     EventHandlerTuio::~EventHandlerTuio() noexcept
     {
+        // キー入力スレッドを止め、端末設定を元に戻す
+        if (this->key_thread_.joinable())
+        {
+            uint64_t one = 1;
+            (void)!write(this->wake_fd_, &one, sizeof(one));
+            this->key_thread_.join();
+        }
+
+        if (this->wake_fd_ >= 0)
+            close(this->wake_fd_);
+
+        if (this->raw_mode_)
+            tcsetattr(STDIN_FILENO, TCSANOW, &this->orig_termios_);
+
         printLog("Destroy Event handler with TUIO");
     }
 
@@ -43,82 +89,117 @@ namespace tll
 
         this->server_->initFrame(TUIO::TuioTime::getSystemTime());
 
-        std::thread osc_thread(threadListen);
-        osc_thread.detach();
+        listenTouchEvents();
+
+        // 端末からの起動時は、キーを1文字ずつエコー無しで受け取れるようにしておく
+        if (isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &this->orig_termios_) == 0)
+        {
+            struct termios raw = this->orig_termios_;
+            raw.c_lflag &= ~(ICANON | ECHO);
+            raw.c_cc[VMIN]  = 1;
+            raw.c_cc[VTIME] = 0;
+
+            this->raw_mode_ = (tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0);
+        }
+
+        this->wake_fd_ = eventfd(0, EFD_CLOEXEC);
+        if (this->wake_fd_ >= 0)
+            this->key_thread_ = std::thread(&EventHandlerTuio::threadKeyInput, this);
     }
 
-    int EventHandlerTuio::kbhit()
+    void EventHandlerTuio::threadKeyInput()
     {
-        struct termios oldt, newt;
-        int ch;
-        int oldf;
-
-        tcgetattr(STDIN_FILENO, &oldt);
-        newt = oldt;
-        newt.c_lflag &= ~(ICANON | ECHO);
-        tcsetattr(STDIN_FILENO, TCSANOW, &newt);
-        oldf = fcntl(STDIN_FILENO, F_GETFL, 0);
-        fcntl(STDIN_FILENO, F_SETFL, oldf | O_NONBLOCK);
+        int epoll_fd = epoll_create1(0);
+        if (epoll_fd < 0)
+            return;
 
-        ch = getchar();
+        struct epoll_event ev = {};
+        ev.events  = EPOLLIN;
+        ev.data.fd = STDIN_FILENO;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, STDIN_FILENO, &ev);
 
-        tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
-        fcntl(STDIN_FILENO, F_SETFL, oldf);
+        ev.data.fd = this->wake_fd_;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, this->wake_fd_, &ev);
 
-        if (ch != EOF)
+        // キー入力か停止通知があるまで眠る
+        while (true)
         {
-            ungetc(ch, stdin);
-            return 1;
+            struct epoll_event events[2];
+            int n = epoll_wait(epoll_fd, events, 2, -1);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0)
+                break;
+
+            bool stop = false;
+            for (int i = 0; i < n; i++)
+            {
+                if (events[i].data.fd == this->wake_fd_)
+                {
+                    stop = true;
+                    continue;
+                }
+
+                char buf[16];
+                ssize_t len = read(STDIN_FILENO, buf, sizeof(buf));
+                if (len <= 0)
+                {
+                    // 標準入力が閉じられた場合は監視をやめる
+                    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, STDIN_FILENO, nullptr);
+                    continue;
+                }
+
+                std::lock_guard<std::mutex> lock(this->key_mutex_);
+                for (ssize_t j = 0; j < len; j++)
+                    this->key_queue_.push_back(static_cast<unsigned char>(buf[j]));
+                this->key_pending_ = true;
+            }
+
+            if (stop)
+                break;
         }
 
-        return 0;
+        close(epoll_fd);
     }
 
     void EventHandlerTuio::updateState()
     {
         // Initialize frame for TUIO
-        this->server_->initFrame(TUIO::TuioTime::getSessionTime());
+        {
+            std::lock_guard<std::mutex> lock(this->getEventMutex());
+            this->server_->initFrame(TUIO::TuioTime::getSessionTime());
+        }
 
-        if (this->kbhit())
+        if (!this->key_pending_)
+            return;
+
+        std::vector<int> keys;
         {
-            int ch = getchar();
+            std::lock_guard<std::mutex> lock(this->key_mutex_);
+            keys.swap(this->key_queue_);
+            this->key_pending_ = false;
+        }
 
-            if (ch == 27)
+        for (int ch : keys)
+        {
+            if (ch == QUIT_KEY)
             {
                 this->setQuitFlag(true);
+                continue;
             }
-            /* キー入力による即時アプリ切り替え処理 */
-            else if (ch == '1')
-            {
-                OscHandler::sendMessageWithString("/tll/switch", "home", "127.0.0.1", 44101);
-            }
-            else if (ch == '2')
-            {
-                OscHandler::sendMessageWithString("/tll/switch", "TouchPoints", "127.0.0.1", 44101);
-            }
-            else if (ch == '3')
-            {
-                OscHandler::sendMessageWithString("/tll/switch", "Rain", "127.0.0.1", 44101);
-            }
-            else if (ch == '4')
-            {
-                OscHandler::sendMessageWithString("/tll/switch", "MultiTouchLine", "127.0.0.1", 44101);
-            }
-            else if (ch == '5')
-            {
-                OscHandler::sendMessageWithString("/tll/switch", "CockroachShooting", "127.0.0.1", 44101);
-            }
-            else if (ch == '6')
-            {
-                OscHandler::sendMessageWithString("/tll/switch", "Theremin", "127.0.0.1", 44101);
-            }
-            else if (ch == '7')
-            {
-                OscHandler::sendMessageWithString("/tll/switch", "MusicVisualizer", "127.0.0.1", 44101);
-            }
-            else if (ch == '8')
+
+            // 操作はメインループでフレームの境界に適用される
+            for (const auto& binding : KEY_BINDINGS)
             {
-                OscHandler::sendMessageWithString("/tll/switch", "ADIR01P_Light", "127.0.0.1", 44101);
+                if (binding.key != ch)
+                    continue;
+
+                if (binding.command == ECommand::SWITCH_APP)
+                    TLL_ENGINE(CommandBus)->postSwitchApp(binding.app_name);
+                else if (binding.command == ECommand::SET_BRIGHTNESS)
+                    TLL_ENGINE(CommandBus)->postBrightness(static_cast<uint8_t>(binding.value));
+                else
+                    TLL_ENGINE(CommandBus)->post(Command{ binding.command, binding.value, {}, {} });
             }
         }
     }
@@ -131,6 +212,7 @@ namespace tll
         {
             TUIO::TuioObject* tobj = this->server_->addTuioObject(id, x, y, 0);
             this->tobj_list_[id] = tobj;
+            this->tuio_sent_++;
         }
         else
         {
@@ -138,10 +220,12 @@ namespace tll
         }
 
         this->server_->commitFrame();
+        TLL_ENGINE(LatencyTracer)->mark(id, ETraceStage::TUIO_SENT);
     }
 
     void EventHandlerTuio::updateTouchedPoint(uint32_t id, int32_t x, int32_t y)
     {
+        this->tuio_sent_++;
         this->server_->updateTuioObject(this->tobj_list_[id], x, y, 0);
     }
 
@@ -149,6 +233,8 @@ namespace tll
     {
         this->server_->removeTuioObject(this->tobj_list_[id]);
         this->server_->commitFrame();
+        this->tuio_sent_++;
+        TLL_ENGINE(LatencyTracer)->mark(id, ETraceStage::TUIO_SENT);
 
         this->tobj_list_.erase(id);
     }
@@ -161,6 +247,7 @@ namespace tll
         {
             TUIO::TuioBlob* tblob = this->server_->addTuioBlob(x, y, 0, w, h, w * h);
             this->tblob_list_[id] = tblob;
+            this->tuio_sent_++;
         }
         else
         {
@@ -172,6 +259,7 @@ namespace tll
 
     void EventHandlerTuio::updateTouchedBlob(uint32_t id, int32_t x, int32_t y, int32_t w, int32_t h)
     {
+        this->tuio_sent_++;
         this->server_->updateTuioBlob(this->tblob_list_[id], x, y, 0, w, h, w * h);
     }
 
@@ -179,18 +267,22 @@ namespace tll
     {
         this->server_->removeTuioBlob(this->tblob_list_[id]);
         this->server_->commitFrame();
+        this->tuio_sent_++;
 
         this->tblob_list_.erase(id);
     }
 
     uint32_t EventHandlerTuio::getTouchedNum()
     {
+        if (this->touched_num_source_)
+            return this->touched_num_source_->load(std::memory_order_relaxed);
+
         return this->tobj_list_.size();
     }
 
     void OscReceiver::ProcessMessage(const osc::ReceivedMessage& msg, const IpEndpointName& remote_end_pt)
     {
-        std::lock_guard<std::mutex> lock(this->osc_mutex_);
+        std::lock_guard<std::mutex> lock(TLL_ENGINE(EventHandler)->getEventMutex());
 
         (void)remote_end_pt;
 
@@ -199,6 +291,8 @@ namespace tll
             osc::ReceivedMessage::const_iterator arg = msg.ArgumentsBegin();
             std::vector<std::string> words = this->split(msg.AddressPattern());    // OSCメッセージを分割する
 
+            TLL_ENGINE(EventHandler)->countReceived();
+
             /****************
              * タッチ点処理 *
              ****************/
@@ -206,12 +300,17 @@ namespace tll
             {
                 int32_t x = (arg++)->AsInt32();
                 int32_t y = (arg++)->AsInt32();
+                uint32_t id = std::atoi(words.at(1).c_str());
 
-                TLL_ENGINE(EventHandler)->addTouchedPoint(std::atoi(words.at(1).c_str()), x, y);
+                TLL_ENGINE(LatencyTracer)->begin(id);
+                TLL_ENGINE(EventHandler)->addTouchedPoint(id, x, y);
             }
             else if (words.at(0) == "touch" && words.at(2) == "delete")    // タッチ点が削除された場合
             {
-                TLL_ENGINE(EventHandler)->removeTouchedPoint(std::atoi(words.at(1).c_str()));
+                uint32_t id = std::atoi(words.at(1).c_str());
+
+                TLL_ENGINE(LatencyTracer)->begin(id);
+                TLL_ENGINE(EventHandler)->removeTouchedPoint(id);
             }
             /******************
              * タッチ領域処理 *
@@ -230,8 +329,9 @@ namespace tll
                 TLL_ENGINE(EventHandler)->removeTouchedBlob(std::atoi(words.at(1).c_str()));
             }
         }
-        catch (osc::Exception& e)
+        catch (std::exception& e)    // 引数の型・数やアドレスが不正なメッセージ
         {
+            TLL_ENGINE(EventHandler)->countDropped();
             std::cout << "OSC error" << std::endl;
         }
     }
@@ -252,12 +352,10 @@ namespace tll
         return words;
     }
 
-    void threadListen()
+    void listenTouchEvents()
     {
-        OscReceiver receiver;
-        UdpListeningReceiveSocket sock(IpEndpointName(IpEndpointName::ANY_ADDRESS, 9000), &receiver);
-
-        sock.Run();
+        // 受信スレッドからプロセス終了まで参照されるため解放しない
+        UdpReactor::get()->listen(9000, new OscReceiver());
     }
 
 }
@@ -0,0 +1,137 @@
+/**
+ * @file    FrameWatchdog.cpp
+ * @brief   Per-app frame budget watchdog
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#include "FrameWatchdog.hpp"
+
+#include <algorithm>
+
+namespace tll
+{
+
+    FrameWatchdog::FrameWatchdog() noexcept
+        : FrameWatchdog(BudgetConfig{})
+    {
+    }
+
+    FrameWatchdog::FrameWatchdog(BudgetConfig config) noexcept
+        : config_(config)
+    {
+        this->reset();
+    }
+
+    void FrameWatchdog::reset()
+    {
+        this->frame_          = 0;
+        this->dropped_frames_ = 0;
+        this->last_us_        = 0;
+        this->quality_        = FrameContext::QUALITY_MAX;
+        this->throttle_       = 1;
+        this->over_streak_    = 0;
+        this->under_streak_   = 0;
+    }
+
+    bool FrameWatchdog::begin(FrameContext& ctx)
+    {
+        // 間引き中は間隔ごとにrun()を呼ぶ
+        if (this->frame_++ % this->throttle_ != 0)
+            return false;
+
+        this->start_tp_ = std::chrono::steady_clock::now();
+
+        ctx.frame          = this->frame_;
+        ctx.budget_us      = this->config_.budget_us;
+        ctx.last_us        = this->last_us_;
+        ctx.dropped_frames = this->dropped_frames_;
+        ctx.quality        = this->quality_;
+        ctx.deadline       = this->start_tp_ + std::chrono::microseconds(this->config_.budget_us);
+
+        return true;
+    }
+
+    EBudgetAction FrameWatchdog::end(FrameContext& ctx)
+    {
+        this->last_us_ = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - this->start_tp_
+        ).count());
+
+        if (this->last_us_ > this->config_.budget_us)
+        {
+            this->dropped_frames_++;
+            this->over_streak_++;
+            this->under_streak_ = 0;
+        }
+        else if (this->last_us_ <= this->config_.budget_us / 2)
+        {
+            this->under_streak_++;
+            this->over_streak_ = 0;
+        }
+        else
+        {
+            // 予算内だが余裕は無い（現在の品質を維持する）
+            this->over_streak_  = 0;
+            this->under_streak_ = 0;
+        }
+
+        EBudgetAction action = this->update();
+
+        ctx.last_us        = this->last_us_;
+        ctx.dropped_frames = this->dropped_frames_;
+        ctx.quality        = this->quality_;
+
+        return action;
+    }
+
+    EBudgetAction FrameWatchdog::update()
+    {
+        // 超過が続く場合は、品質 → 実行間隔 → 降格の順に対応する
+        if (this->over_streak_ >= this->config_.degrade_frames)
+        {
+            if (this->quality_ > 0)
+            {
+                this->quality_--;
+                this->over_streak_ = 0;
+                return EBudgetAction::DEGRADE;
+            }
+
+            if (this->throttle_ < this->config_.max_throttle)
+            {
+                this->throttle_ = std::min(this->throttle_ * 2, this->config_.max_throttle);
+                this->over_streak_ = 0;
+                return EBudgetAction::THROTTLE;
+            }
+
+            if (this->config_.demote_frames > 0 && this->over_streak_ >= this->config_.demote_frames)
+            {
+                this->over_streak_ = 0;
+                return EBudgetAction::DEMOTE;
+            }
+
+            return EBudgetAction::NONE;
+        }
+
+        // 余裕がある場合は、間隔 → 品質の順に戻す
+        if (this->under_streak_ >= this->config_.restore_frames)
+        {
+            this->under_streak_ = 0;
+
+            if (this->throttle_ > 1)
+            {
+                this->throttle_ /= 2;
+                return EBudgetAction::RESTORE;
+            }
+
+            if (this->quality_ < FrameContext::QUALITY_MAX)
+            {
+                this->quality_++;
+                return EBudgetAction::RESTORE;
+            }
+        }
+
+        return EBudgetAction::NONE;
+    }
+
+}
@@ -0,0 +1,379 @@
+/**
+ * @file    Gesture.cpp
+ * @brief   Gesture recognition
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#include "Gesture.hpp"
+
+#include <cmath>
+#include <cstdlib>
+
+namespace tll
+{
+
+    GestureRecognizer::GestureRecognizer() noexcept
+        : GestureRecognizer(GestureConfig())
+    {
+    }
+
+    GestureRecognizer::GestureRecognizer(GestureConfig config) noexcept
+        : config_(config)
+        , active_num_(0)
+        , has_last_tap_(false)
+        , last_tap_x_(0)
+        , last_tap_y_(0)
+        , hold_fired_(false)
+        , pinching_(false)
+        , pinch_distance_(0.f)
+        , pinch_angle_(0.f)
+        , pending_head_(0)
+        , pending_num_(0)
+    {
+    }
+
+    void GestureRecognizer::touch(const TouchInfo& ti)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        TouchState* ts = this->find(ti.id);
+        if (ts == nullptr)
+        {
+            ts = this->allocate(ti.id);
+            if (ts == nullptr)
+                return;    // 追跡可能な点数を超えた場合は無視する
+
+            this->active_num_++;
+        }
+
+        ts->active  = true;
+        ts->moved   = false;
+        ts->long_pressed = false;
+        ts->multi   = false;
+        ts->start_x = ti.x;
+        ts->start_y = ti.y;
+        ts->x = ti.x;
+        ts->y = ti.y;
+        ts->start_time = std::chrono::steady_clock::now();
+
+        if (this->active_num_ >= 2)
+        {
+            for (auto& t : this->touches_)
+            {
+                if (t.active)
+                    t.multi = true;
+            }
+        }
+
+        // 指の本数が変わったらホールド判定をやり直す
+        this->hold_fired_ = false;
+        this->hold_start_time_ = ts->start_time;
+
+        this->pinching_ = false;
+        if (this->active_num_ == 2)
+            this->beginPinch();
+    }
+
+    void GestureRecognizer::move(const TouchInfo& ti)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        TouchState* ts = this->find(ti.id);
+        if (ts == nullptr)
+            return;
+
+        ts->x = ti.x;
+        ts->y = ti.y;
+
+        if (std::abs(ts->x - ts->start_x) > this->config_.slop || std::abs(ts->y - ts->start_y) > this->config_.slop)
+            ts->moved = true;
+
+        if (!this->pinching_)
+            return;
+
+        // 2点間の距離・角度の変化からピンチを判定する
+        const TouchState* p[2];
+        uint32_t n = 0;
+        for (auto& t : this->touches_)
+        {
+            if (t.active)
+                p[n++] = &t;
+            if (n == 2)
+                break;
+        }
+
+        float dx = static_cast<float>(p[1]->x - p[0]->x);
+        float dy = static_cast<float>(p[1]->y - p[0]->y);
+        float distance = std::sqrt(dx * dx + dy * dy);
+
+        if (!p[0]->moved && !p[1]->moved)
+            return;
+
+        GestureInfo gi{};
+        gi.type     = EGestureType::PINCH;
+        gi.fingers  = 2;
+        gi.x        = (p[0]->x + p[1]->x) / 2;
+        gi.y        = (p[0]->y + p[1]->y) / 2;
+        gi.scale    = (this->pinch_distance_ > 0.f) ? distance / this->pinch_distance_ : 1.f;
+        gi.duration = elapsed(this->pinch_start_time_, std::chrono::steady_clock::now());
+
+        // 2点を結ぶ向きが負のx軸を横切っても回転角が2πずれないよう (-π, π] に収める
+        constexpr float PI = 3.14159265358979f;
+        gi.rotation = std::atan2(dy, dx) - this->pinch_angle_;
+        if (gi.rotation > PI)
+            gi.rotation -= 2.f * PI;
+        else if (gi.rotation <= -PI)
+            gi.rotation += 2.f * PI;
+
+        // 拡大率・回転角は開始時点が基準のため、取り出されていないピンチは最新のもので置き換える
+        // （移動ごとに積むと、同じフレームの他のジェスチャが溢れて捨てられる）
+        if (this->pending_num_ > 0)
+        {
+            GestureInfo& last = this->pending_[(this->pending_head_ + this->pending_num_ - 1) % MAX_PENDING];
+            if (last.type == EGestureType::PINCH)
+            {
+                last = gi;
+                return;
+            }
+        }
+
+        this->emit(gi);
+    }
+
+    void GestureRecognizer::release(const TouchInfo& ti)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        TouchState* ts = this->find(ti.id);
+        if (ts == nullptr)
+            return;
+
+        TimePoint now = std::chrono::steady_clock::now();
+        uint32_t duration = elapsed(ts->start_time, now);
+
+        ts->x = ti.x;
+        ts->y = ti.y;
+
+        int32_t dx = ts->x - ts->start_x;
+        int32_t dy = ts->y - ts->start_y;
+
+        // 単独の指で成立するジェスチャはピンチ・ホールドに関わった点では判定しない
+        bool single = !ts->multi;
+
+        if (single && !ts->moved && !ts->long_pressed && duration <= this->config_.tap_time)
+        {
+            GestureInfo gi{};
+            gi.type     = EGestureType::TAP;
+            gi.fingers  = 1;
+            gi.x        = ts->x;
+            gi.y        = ts->y;
+            gi.duration = duration;
+            this->emit(gi);
+
+            if (this->has_last_tap_
+             && elapsed(this->last_tap_time_, now) <= this->config_.double_tap_interval
+             && std::abs(ts->x - this->last_tap_x_) <= this->config_.slop * 2
+             && std::abs(ts->y - this->last_tap_y_) <= this->config_.slop * 2)
+            {
+                gi.type = EGestureType::DOUBLE_TAP;
+                this->emit(gi);
+
+                this->has_last_tap_ = false;
+            }
+            else
+            {
+                this->has_last_tap_ = true;
+                this->last_tap_x_ = ts->x;
+                this->last_tap_y_ = ts->y;
+                this->last_tap_time_ = now;
+            }
+        }
+        else if (single && duration <= this->config_.swipe_time
+              && (std::abs(dx) >= this->config_.swipe_distance || std::abs(dy) >= this->config_.swipe_distance))
+        {
+            GestureInfo gi{};
+            gi.type     = EGestureType::SWIPE;
+            gi.fingers  = 1;
+            gi.x        = ts->start_x;
+            gi.y        = ts->start_y;
+            gi.dx       = dx;
+            gi.dy       = dy;
+            gi.duration = duration;
+            this->emit(gi);
+        }
+
+        ts->active = false;
+        this->active_num_--;
+
+        this->hold_fired_ = false;
+        this->hold_start_time_ = now;
+
+        this->pinching_ = false;
+        if (this->active_num_ == 2)
+            this->beginPinch();
+    }
+
+    void GestureRecognizer::update()
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        if (this->active_num_ == 0)
+            return;
+
+        TimePoint now = std::chrono::steady_clock::now();
+
+        if (this->active_num_ == 1)
+        {
+            for (auto& ts : this->touches_)
+            {
+                if (!ts.active || ts.moved || ts.long_pressed || ts.multi)
+                    continue;
+
+                uint32_t duration = elapsed(ts.start_time, now);
+                if (duration >= this->config_.long_press_time)
+                {
+                    ts.long_pressed = true;
+
+                    GestureInfo gi{};
+                    gi.type     = EGestureType::LONG_PRESS;
+                    gi.fingers  = 1;
+                    gi.x        = ts.x;
+                    gi.y        = ts.y;
+                    gi.duration = duration;
+                    this->emit(gi);
+                }
+            }
+        }
+        else if (!this->hold_fired_)
+        {
+            uint32_t duration = elapsed(this->hold_start_time_, now);
+            if (duration >= this->config_.hold_time)
+            {
+                this->hold_fired_ = true;
+
+                int32_t sum_x = 0;
+                int32_t sum_y = 0;
+                for (auto& ts : this->touches_)
+                {
+                    if (!ts.active)
+                        continue;
+
+                    sum_x += ts.x;
+                    sum_y += ts.y;
+                }
+
+                GestureInfo gi{};
+                gi.type     = EGestureType::HOLD;
+                gi.fingers  = this->active_num_;
+                gi.x        = sum_x / static_cast<int32_t>(this->active_num_);
+                gi.y        = sum_y / static_cast<int32_t>(this->active_num_);
+                gi.duration = duration;
+                this->emit(gi);
+            }
+        }
+    }
+
+    uint32_t GestureRecognizer::getHoldDuration(uint32_t fingers)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        if (this->active_num_ != fingers)
+            return 0;
+
+        return elapsed(this->hold_start_time_, std::chrono::steady_clock::now());
+    }
+
+    void GestureRecognizer::reset()
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        for (auto& ts : this->touches_)
+            ts.active = false;
+
+        this->active_num_   = 0;
+        this->has_last_tap_ = false;
+        this->hold_fired_   = false;
+        this->pinching_     = false;
+        this->pending_num_  = 0;
+    }
+
+    bool GestureRecognizer::poll(GestureInfo& gi)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        if (this->pending_num_ == 0)
+            return false;
+
+        gi = this->pending_[this->pending_head_];
+        this->pending_head_ = (this->pending_head_ + 1) % MAX_PENDING;
+        this->pending_num_--;
+
+        return true;
+    }
+
+    GestureRecognizer::TouchState* GestureRecognizer::find(uint32_t id)
+    {
+        for (auto& ts : this->touches_)
+        {
+            if (ts.active && ts.id == id)
+                return &ts;
+        }
+
+        return nullptr;
+    }
+
+    GestureRecognizer::TouchState* GestureRecognizer::allocate(uint32_t id)
+    {
+        for (auto& ts : this->touches_)
+        {
+            if (!ts.active)
+            {
+                ts.id = id;
+                return &ts;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void GestureRecognizer::beginPinch()
+    {
+        const TouchState* p[2];
+        uint32_t n = 0;
+        for (auto& ts : this->touches_)
+        {
+            if (ts.active)
+                p[n++] = &ts;
+            if (n == 2)
+                break;
+        }
+
+        float dx = static_cast<float>(p[1]->x - p[0]->x);
+        float dy = static_cast<float>(p[1]->y - p[0]->y);
+
+        this->pinching_ = true;
+        this->pinch_distance_ = std::sqrt(dx * dx + dy * dy);
+        this->pinch_angle_ = std::atan2(dy, dx);
+        this->pinch_start_time_ = std::chrono::steady_clock::now();
+    }
+
+    void GestureRecognizer::emit(const GestureInfo& gi)
+    {
+        // 溢れた場合は最も古いジェスチャを捨てる
+        if (this->pending_num_ == MAX_PENDING)
+        {
+            this->pending_head_ = (this->pending_head_ + 1) % MAX_PENDING;
+            this->pending_num_--;
+        }
+
+        this->pending_[(this->pending_head_ + this->pending_num_) % MAX_PENDING] = gi;
+        this->pending_num_++;
+    }
+
+    uint32_t GestureRecognizer::elapsed(TimePoint from, TimePoint to)
+    {
+        return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(to - from).count());
+    }
+
+}
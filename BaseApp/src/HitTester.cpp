@@ -0,0 +1,199 @@
+/**
+ * @file    HitTester.cpp
+ * @brief   Touch region hit testing
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#include "HitTester.hpp"
+
+#include <algorithm>
+
+namespace tll
+{
+
+    HitTester::HitTester() noexcept
+        : width_(0)
+        , height_(0)
+    {
+    }
+
+    void HitTester::init(uint16_t width, uint16_t height)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        this->width_  = width;
+        this->height_ = height;
+        this->index_.assign(width * height, NONE);
+
+        this->rebuild();
+    }
+
+    uint16_t HitTester::addRect(int32_t x, int32_t y, int32_t w, int32_t h, Handler handler)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        return this->add(Region{ true, false, x, y, w, h, handler });
+    }
+
+    uint16_t HitTester::addCircle(int32_t x, int32_t y, int32_t rad, Handler handler)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        return this->add(Region{ true, true, x, y, rad, rad, handler });
+    }
+
+    void HitTester::remove(uint16_t id)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        if (id == NONE || id > this->regions_.size() || !this->regions_[id - 1].active)
+            return;
+
+        this->regions_[id - 1].active  = false;
+        this->regions_[id - 1].handler = nullptr;
+
+        this->free_ids_.push_back(id);
+        this->order_.erase(std::find(this->order_.begin(), this->order_.end(), id));
+
+        // 再利用された領域に、解除前のタッチ点の移動・解放が届かないようにする
+        for (auto it = this->captured_.begin(); it != this->captured_.end();)
+        {
+            if (it->second == id)
+                it = this->captured_.erase(it);
+            else
+                ++it;
+        }
+
+        this->rebuild();
+    }
+
+    void HitTester::clear()
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        this->regions_.clear();
+        this->free_ids_.clear();
+        this->order_.clear();
+        this->captured_.clear();
+        std::fill(this->index_.begin(), this->index_.end(), NONE);
+    }
+
+    uint16_t HitTester::hitTest(int32_t x, int32_t y)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        if (x < 0 || y < 0 || x >= this->width_ || y >= this->height_)
+            return NONE;
+
+        return this->index_[y * this->width_ + x];
+    }
+
+    bool HitTester::dispatch(ETouchEvent event, const TouchInfo& ti)
+    {
+        Handler handler;
+
+        {
+            std::lock_guard<std::mutex> lock(this->mutex_);
+
+            uint16_t id = NONE;
+
+            if (event == ETouchEvent::TOUCHED)
+            {
+                if (ti.x < 0 || ti.y < 0 || ti.x >= this->width_ || ti.y >= this->height_)
+                    return false;
+
+                id = this->index_[ti.y * this->width_ + ti.x];
+                if (id == NONE)
+                    return false;
+
+                this->captured_[ti.id] = id;
+            }
+            else
+            {
+                // 領域の外に出たり、外で離したりしても、触れた領域に届ける
+                auto it = this->captured_.find(ti.id);
+                if (it == this->captured_.end())
+                    return false;
+
+                id = it->second;
+                if (event == ETouchEvent::RELEASED)
+                    this->captured_.erase(it);
+            }
+
+            handler = this->regions_[id - 1].handler;
+        }
+
+        // ハンドラ内から領域を登録・解除できるようロック外で呼び出す
+        if (!handler)
+            return false;
+
+        handler(event, ti);
+        return true;
+    }
+
+    uint16_t HitTester::add(const Region& r)
+    {
+        uint16_t id;
+
+        if (!this->free_ids_.empty())
+        {
+            id = this->free_ids_.back();
+            this->free_ids_.pop_back();
+            this->regions_[id - 1] = r;
+        }
+        else if (this->regions_.size() < UINT16_MAX)
+        {
+            this->regions_.push_back(r);
+            id = static_cast<uint16_t>(this->regions_.size());
+        }
+        else
+            return NONE;
+
+        this->order_.push_back(id);
+        this->rasterize(id, r);
+
+        return id;
+    }
+
+    void HitTester::rasterize(uint16_t id, const Region& r)
+    {
+        if (this->index_.empty())
+            return;
+
+        int32_t left   = r.circle ? r.x - r.w : r.x;
+        int32_t top    = r.circle ? r.y - r.w : r.y;
+        int32_t right  = r.circle ? r.x + r.w : r.x + r.w - 1;
+        int32_t bottom = r.circle ? r.y + r.w : r.y + r.h - 1;
+
+        left   = std::max<int32_t>(left, 0);
+        top    = std::max<int32_t>(top, 0);
+        right  = std::min<int32_t>(right, this->width_ - 1);
+        bottom = std::min<int32_t>(bottom, this->height_ - 1);
+
+        for (int32_t y = top; y <= bottom; y++)
+        {
+            for (int32_t x = left; x <= right; x++)
+            {
+                if (r.circle)
+                {
+                    int32_t dx = x - r.x;
+                    int32_t dy = y - r.y;
+                    if (dx * dx + dy * dy > r.w * r.w)
+                        continue;
+                }
+
+                this->index_[y * this->width_ + x] = id;
+            }
+        }
+    }
+
+    void HitTester::rebuild()
+    {
+        std::fill(this->index_.begin(), this->index_.end(), NONE);
+
+        for (uint16_t id : this->order_)
+            this->rasterize(id, this->regions_[id - 1]);
+    }
+
+}
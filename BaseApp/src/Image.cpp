@@ -12,7 +12,6 @@
 #include "tllEngine.hpp"
 #include "Color.hpp"
 #include "PanelManager.hpp"
-#include "SerialManager.hpp"
 
 namespace tll
 {
@@ -23,63 +22,29 @@ namespace tll
     Image::Image(cv::Mat img_data) noexcept
     {
         img_data_ = img_data;
+        this->convert();
     }
 
-    void Image::draw(uint32_t x, uint32_t y)
+    void Image::draw(uint32_t x, uint32_t y) const
     {
-        // ピクセルごとに画像データの色を適用していく
-        for (int Y = 0; Y < img_data_.rows; Y++)
-        {
-            for (int X = 0; X < img_data_.cols; X++)
-            {
-                TLL_ENGINE(PanelManager)->drawPixel(
-                    x + X,
-                    y + Y,
-                    Color(
-                        img_data_.at<cv::Vec3b>(Y, X)[2],
-                        img_data_.at<cv::Vec3b>(Y, X)[1],
-                        img_data_.at<cv::Vec3b>(Y, X)[0]
-                    )
-                );
-            }
-        }
+        // 変換済みの画素を1行ずつ書き込む（送信はフレームの終わりにまとめて行う）
+        TLL_ENGINE(PanelManager)->drawSurface(static_cast<int32_t>(x), static_cast<int32_t>(y), this->surface_);
+    }
 
-        TLL_ENGINE(SerialManager)->sendColorData();
+    void Image::draw(uint32_t x, uint32_t y, tll::Color color) const
+    {
+        // 色の無いピクセルは黒、色の付いているピクセルは指定色で表示
+        TLL_ENGINE(PanelManager)->drawMask(static_cast<int32_t>(x), static_cast<int32_t>(y), this->mask_, color, false);
     }
 
-    void Image::draw(uint32_t x, uint32_t y, tll::Color color)
+    void Image::drawTransparent(uint32_t x, uint32_t y) const
     {
-        for (int Y = 0; Y < img_data_.rows; Y++)
-        {
-            for (int X = 0; X < img_data_.cols; X++)
-            {
-                // 色の無いピクセルは黒を表示
-                if (img_data_.at<cv::Vec3b>(Y, X)[2] == 0 &&
-                    img_data_.at<cv::Vec3b>(Y, X)[1] == 0 &&
-                    img_data_.at<cv::Vec3b>(Y, X)[0] == 0)
-                {
-                    TLL_ENGINE(PanelManager)->drawPixel(
-                        x + X,
-                        y + Y,
-                        Color(0, 0, 0)
-                    );
-                }
-                else    // 色の付いているピクセルは指定色で表示
-                {
-                    TLL_ENGINE(PanelManager)->drawPixel(
-                        x + X,
-                        y + Y,
-                        Color(
-                            color.r_,
-                            color.g_,
-                            color.b_
-                        )
-                    );
-                }
-            }
-        }
+        TLL_ENGINE(PanelManager)->drawSurfaceMasked(static_cast<int32_t>(x), static_cast<int32_t>(y), this->surface_, this->mask_);
+    }
 
-        TLL_ENGINE(SerialManager)->sendColorData();
+    void Image::drawTransparent(uint32_t x, uint32_t y, tll::Color color) const
+    {
+        TLL_ENGINE(PanelManager)->drawMask(static_cast<int32_t>(x), static_cast<int32_t>(y), this->mask_, color, true);
     }
 
     void Image::resize(uint32_t height, uint32_t width)
@@ -88,5 +53,25 @@ namespace tll
 
         cv::resize(img_data_, dst, dst.size());
         img_data_ = dst;
+
+        this->convert();
+    }
+
+    void Image::convert()
+    {
+        this->surface_.resize(img_data_.cols, img_data_.rows);
+
+        // OpenCVのBGRからパネルのRGBに並べ替える
+        for (int Y = 0; Y < img_data_.rows; Y++)
+        {
+            const cv::Vec3b* src = img_data_.ptr<cv::Vec3b>(Y);
+            Color* dst = &this->surface_.pixels[Y * img_data_.cols];
+
+            for (int X = 0; X < img_data_.cols; X++)
+                dst[X] = Color(src[X][2], src[X][1], src[X][0]);
+        }
+
+        // 描画のたびに黒かどうかを判定しないよう、マスクを作っておく
+        this->mask_.build(this->surface_);
     }
 }
@@ -0,0 +1,227 @@
+/**
+ * @file    LatencyTracer.cpp
+ * @brief   Touch-to-photon latency tracing
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#include "LatencyTracer.hpp"
+
+#include <chrono>
+
+#include "Common.hpp"
+
+namespace tll
+{
+
+    namespace
+    {
+        constexpr size_t stageIndex(ETraceStage stage)
+        {
+            return static_cast<size_t>(stage);
+        }
+
+        // 段階間の分布は後段の添字に入れるので、空いている先頭の添字に全体の分布を入れる
+        constexpr size_t TOTAL = stageIndex(ETraceStage::OSC_RECEIVED);
+    }
+
+    void LatencyHistogram::add(uint32_t us) noexcept
+    {
+        this->buckets_[toBucket(us)]++;
+        this->count_++;
+    }
+
+    uint32_t LatencyHistogram::percentile(double p) const noexcept
+    {
+        if (this->count_ == 0)
+            return 0;
+
+        uint64_t target = static_cast<uint64_t>(p * this->count_ / 100.0);
+        uint64_t sum = 0;
+
+        for (uint32_t i = 0; i < this->buckets_.size(); i++)
+        {
+            sum += this->buckets_[i];
+            if (sum > target)
+                return upperBound(i);
+        }
+
+        return upperBound(static_cast<uint32_t>(this->buckets_.size() - 1));
+    }
+
+    uint32_t LatencyHistogram::toBucket(uint32_t us) noexcept
+    {
+        if (us < 4)
+            return us;
+
+        uint32_t e = 31 - __builtin_clz(us);
+        uint32_t m = (us >> (e - 2)) & 3;
+
+        return 4 + (e - 2) * 4 + m;
+    }
+
+    uint32_t LatencyHistogram::upperBound(uint32_t bucket) noexcept
+    {
+        if (bucket < 4)
+            return bucket;
+
+        uint32_t e = (bucket - 4) / 4 + 2;
+        uint32_t m = (bucket - 4) % 4;
+
+        return static_cast<uint32_t>((static_cast<uint64_t>(4 + m + 1) << (e - 2)) - 1);
+    }
+
+    ILatencyTracer* ILatencyTracer::create()
+    {
+        return new LatencyTracer();
+    }
+
+    uint64_t ILatencyTracer::now() noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count();
+    }
+
+    LatencyTracer::LatencyTracer() noexcept
+        : next_trace_id_(1)
+    {
+        printLog("Create Latency tracer");
+    }
+
+    LatencyTracer::~LatencyTracer() noexcept
+    {
+        printLog("Destroy Latency tracer");
+    }
+
+    uint64_t LatencyTracer::begin(uint32_t touch_id)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        // 同じタッチ点の未完了のトレースは新しいイベントで置き換える
+        Trace* trace = this->find(touch_id);
+        if (trace == nullptr)
+        {
+            // 空きが無い場合は途中で失われた最も古いトレースを再利用する
+            trace = &this->traces_[0];
+            for (auto& t : this->traces_)
+            {
+                if (!t.active)
+                {
+                    trace = &t;
+                    break;
+                }
+
+                if (t.time[0] < trace->time[0])
+                    trace = &t;
+            }
+        }
+
+        trace->active   = true;
+        trace->in_frame = false;
+        trace->touch_id = touch_id;
+        trace->trace_id = this->next_trace_id_++;
+        trace->time.fill(0);
+        trace->time[stageIndex(ETraceStage::OSC_RECEIVED)] = now();
+
+        return trace->trace_id;
+    }
+
+    void LatencyTracer::mark(uint32_t touch_id, ETraceStage stage)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        Trace* trace = this->find(touch_id);
+        if (trace == nullptr || stage == ETraceStage::OSC_RECEIVED)
+            return;
+
+        // 前の段階を通過していない記録は無視する
+        size_t i = stageIndex(stage);
+        if (trace->time[i - 1] == 0 || trace->time[i] != 0)
+            return;
+
+        trace->time[i] = now();
+    }
+
+    bool LatencyTracer::lookup(uint32_t touch_id, uint64_t& trace_id, uint64_t& timestamp)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        Trace* trace = this->find(touch_id);
+        if (trace == nullptr)
+            return false;
+
+        trace_id  = trace->trace_id;
+        timestamp = trace->time[stageIndex(ETraceStage::OSC_RECEIVED)];
+
+        return true;
+    }
+
+    void LatencyTracer::beginFrame()
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        // 描画を終えたトレースだけがこのフレームに反映される
+        for (auto& t : this->traces_)
+        {
+            if (t.active && t.time[stageIndex(ETraceStage::APP_HANDLED)] != 0)
+                t.in_frame = true;
+        }
+    }
+
+    void LatencyTracer::endFrame()
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        uint64_t t_now = now();
+
+        for (auto& t : this->traces_)
+        {
+            if (!t.active || !t.in_frame)
+                continue;
+
+            t.time[stageIndex(ETraceStage::FRAME_PUBLISHED)] = t_now;
+
+            for (size_t i = 1; i < t.time.size(); i++)
+                this->histograms_[i].add(static_cast<uint32_t>(t.time[i] - t.time[i - 1]));
+            this->histograms_[TOTAL].add(static_cast<uint32_t>(t_now - t.time[0]));
+
+            t.active   = false;
+            t.in_frame = false;
+        }
+    }
+
+    LatencyStats LatencyTracer::getStats()
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        auto toStats = [this](size_t i)
+        {
+            return LatencyStageStats{
+                this->histograms_[i].getCount(),
+                this->histograms_[i].percentile(50.0),
+                this->histograms_[i].percentile(99.0)
+            };
+        };
+
+        return LatencyStats{
+            toStats(stageIndex(ETraceStage::TUIO_SENT)),
+            toStats(stageIndex(ETraceStage::TUIO_RECEIVED)),
+            toStats(stageIndex(ETraceStage::APP_HANDLED)),
+            toStats(stageIndex(ETraceStage::FRAME_PUBLISHED)),
+            toStats(TOTAL)
+        };
+    }
+
+    LatencyTracer::Trace* LatencyTracer::find(uint32_t touch_id)
+    {
+        for (auto& t : this->traces_)
+        {
+            if (t.active && t.touch_id == touch_id)
+                return &t;
+        }
+
+        return nullptr;
+    }
+
+}
@@ -5,55 +5,268 @@
 
 #include "OscHandler.hpp"
 
+#include <algorithm>
+#include <arpa/inet.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
 #include "BaseApp.hpp"
+#include "CommandBus.hpp"
+#include "tllEngine.hpp"
+#include "UdpReactor.hpp"
 
 namespace tll
 {
 
-    void OscHandler::sendMessage(const char* address, const char* dst_ip, int port)
+    namespace
     {
-        UdpTransmitSocket transmitSocket(IpEndpointName(dst_ip, port));
+        // 1つのバンドルの最大サイズ（UDPで分割されない大きさに抑える）
+        constexpr size_t MAX_BUNDLE_SIZE = 1400;
+
+        /* 送信先ごとにメッセージをまとめ、送信スレッドでバンドルとして送るクラス */
+        class OscOutbox
+        {
+        public:
+            static OscOutbox& get()
+            {
+                static OscOutbox* outbox = new OscOutbox();    // 送信スレッドが参照し続けるため解放しない
+                return *outbox;
+            }
+
+            // 送信先のバンドルにメッセージを追加する
+            void push(const char* dst_ip, int port, const char* data, size_t size)
+            {
+                std::lock_guard<std::mutex> lock(this->mutex_);
+
+                std::vector<char>& elements = this->pending_[Destination(dst_ip, port)];
+
+                // バンドル要素は「サイズ(int32, ビッグエンディアン) + メッセージ」
+                uint32_t be_size = htonl(static_cast<uint32_t>(size));
+                const char* p = reinterpret_cast<const char*>(&be_size);
+                elements.insert(elements.end(), p, p + 4);
+                elements.insert(elements.end(), data, data + size);
+            }
+
+            // これまでに追加したメッセージを送信する（syncがfalseの場合は送信スレッドに任せる）
+            void flush(bool sync)
+            {
+                if (sync)
+                {
+                    std::lock_guard<std::mutex> send_lock(this->send_mutex_);
+
+                    Pending pending;
+                    {
+                        std::lock_guard<std::mutex> lock(this->mutex_);
+                        pending.swap(this->pending_);
+                    }
+
+                    this->send(pending);
+                    return;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(this->mutex_);
+                    if (this->pending_.empty())
+                        return;
+
+                    this->flush_requested_ = true;
+                }
+
+                this->cv_.notify_one();
+            }
+
+        private:
+            using Destination = std::pair<std::string, int>;
+            using Pending = std::map<Destination, std::vector<char>>;
+
+            OscOutbox()
+                : flush_requested_(false)
+            {
+                std::thread th(&OscOutbox::run, this);
+                th.detach();
+            }
+
+            void run()
+            {
+                while (true)
+                {
+                    Pending pending;
+
+                    {
+                        // フレーム境界でのflushを待つ（ループ外から送られたメッセージも取りこぼさないよう一定時間で送る）
+                        std::unique_lock<std::mutex> lock(this->mutex_);
+                        this->cv_.wait_for(lock, std::chrono::milliseconds(33), [this] { return this->flush_requested_; });
+
+                        this->flush_requested_ = false;
+                        pending.swap(this->pending_);
+                    }
+
+                    if (pending.empty())
+                        continue;
+
+                    std::lock_guard<std::mutex> send_lock(this->send_mutex_);
+                    this->send(pending);
+                }
+            }
+
+            void send(Pending& pending)
+            {
+                for (auto& [dst, elements] : pending)
+                {
+                    try
+                    {
+                        this->sendBundles(dst, elements);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        // 送信に失敗したソケットは次回作り直す
+                        this->sockets_.erase(dst);
+                        std::cerr << "[OSC ERROR]: " << e.what() << '\n';
+                    }
+                }
+            }
+
+            // 送信先のメッセージをバンドルに分けて送る
+            void sendBundles(const Destination& dst, const std::vector<char>& elements)
+            {
+                static const char header[16] = { '#', 'b', 'u', 'n', 'd', 'l', 'e', '\0', 0, 0, 0, 0, 0, 0, 0, 1 };    // 即時実行
+
+                UdpTransmitSocket* sock = this->getSocket(dst);
+
+                this->bundle_.assign(header, header + sizeof(header));
+
+                size_t pos = 0;
+                while (pos < elements.size())
+                {
+                    uint32_t size;
+                    std::memcpy(&size, &elements[pos], 4);
+                    size_t element_size = 4 + ntohl(size);
 
+                    // 収まらない場合はそこまでを1つのバンドルとして送る
+                    if (this->bundle_.size() > sizeof(header) && this->bundle_.size() + element_size > MAX_BUNDLE_SIZE)
+                    {
+                        sock->Send(this->bundle_.data(), this->bundle_.size());
+                        this->bundle_.resize(sizeof(header));
+                    }
+
+                    this->bundle_.insert(this->bundle_.end(), elements.begin() + pos, elements.begin() + pos + element_size);
+                    pos += element_size;
+                }
+
+                if (this->bundle_.size() > sizeof(header))
+                    sock->Send(this->bundle_.data(), this->bundle_.size());
+            }
+
+            // 送信先ごとのソケットを使い回す
+            UdpTransmitSocket* getSocket(const Destination& dst)
+            {
+                auto it = this->sockets_.find(dst);
+                if (it != this->sockets_.end())
+                    return it->second.get();
+
+                auto sock = std::make_unique<UdpTransmitSocket>(IpEndpointName(dst.first.c_str(), dst.second));
+                return (this->sockets_[dst] = std::move(sock)).get();
+            }
+
+            // 送信待ちのバンドル要素（送信先ごと）
+            Pending pending_;
+            bool flush_requested_;
+
+            std::mutex mutex_;
+            std::condition_variable cv_;
+
+            // 送信処理用（送信スレッドと同期送信の排他）
+            std::mutex send_mutex_;
+            std::map<Destination, std::unique_ptr<UdpTransmitSocket>> sockets_;
+            std::vector<char> bundle_;
+        };
+    }
+
+    void OscHandler::sendMessage(const char* address, const char* dst_ip, int port)
+    {
         char buff[2048];
         osc::OutboundPacketStream p(buff, 2048);
 
-        p << osc::BeginBundleImmediate << osc::BeginMessage(address) << osc::EndMessage << osc::EndBundle;
-        transmitSocket.Send(p.Data(), p.Size());
+        p << osc::BeginMessage(address) << osc::EndMessage;
+        OscOutbox::get().push(dst_ip, port, p.Data(), p.Size());
     }
 
     void OscHandler::sendMessageWithInt32(const char* address, int32_t value, const char* dst_ip, int port)
     {
-        UdpTransmitSocket transmitSocket(IpEndpointName(dst_ip, port));
-
         char buff[2048];
         osc::OutboundPacketStream p(buff, 2048);
 
-        p << osc::BeginBundleImmediate << osc::BeginMessage(address) << value << osc::EndMessage << osc::EndBundle;
-        transmitSocket.Send(p.Data(), p.Size());
+        p << osc::BeginMessage(address) << value << osc::EndMessage;
+        OscOutbox::get().push(dst_ip, port, p.Data(), p.Size());
     }
 
     void OscHandler::sendMessageWithFloat(const char* address, float value, const char* dst_ip, int port)
     {
-        UdpTransmitSocket transmitSocket(IpEndpointName(dst_ip, port));
-
         char buff[2048];
         osc::OutboundPacketStream p(buff, 2048);
 
-        p << osc::BeginBundleImmediate << osc::BeginMessage(address) << value << osc::EndMessage << osc::EndBundle;
-        transmitSocket.Send(p.Data(), p.Size());
+        p << osc::BeginMessage(address) << value << osc::EndMessage;
+        OscOutbox::get().push(dst_ip, port, p.Data(), p.Size());
     }
 
     void OscHandler::sendMessageWithString(const char* address, std::string value, const char* dst_ip, int port)
     {
-        UdpTransmitSocket transmitSocket(IpEndpointName(dst_ip, port));
-
         char buff[2048];
         osc::OutboundPacketStream p(buff, 2048);
 
-        p << osc::BeginBundleImmediate << osc::BeginMessage(address) << value.c_str() << osc::EndMessage << osc::EndBundle;
-        transmitSocket.Send(p.Data(), p.Size());
+        p << osc::BeginMessage(address) << value.c_str() << osc::EndMessage;
+        OscOutbox::get().push(dst_ip, port, p.Data(), p.Size());
+    }
+
+    void OscHandler::flush(bool sync)
+    {
+        OscOutbox::get().flush(sync);
     }
     
+    OscHandler::OscHandler(class BaseApp* base_app) noexcept
+        : app_ref(base_app)
+    {
+        // 制御コマンドはメインループでフレームの境界に適用される
+        this->routes_.routeString("/tll/switch", [](const char* app_name)
+        {
+            TLL_ENGINE(CommandBus)->postSwitchApp(app_name);
+        });
+
+        this->routes_.routeInt32("/tll/pause", [](int32_t pause)
+        {
+            TLL_ENGINE(CommandBus)->postPause(pause != 0);
+        });
+
+        this->routes_.routeInt32("/tll/brightness", [](int32_t brightness)
+        {
+            TLL_ENGINE(CommandBus)->postBrightness(static_cast<uint8_t>(std::clamp(brightness, 0, 255)));
+        });
+
+        // 引数: アプリ名, x, y, w, h
+        this->routes_.route("/tll/viewport/open", [](const osc::ReceivedMessage& msg)
+        {
+            osc::ReceivedMessageArgumentStream args = msg.ArgumentStream();
+            const char* app_name;
+            osc::int32 x, y, w, h;
+            args >> app_name >> x >> y >> w >> h >> osc::EndMessage;
+
+            TLL_ENGINE(CommandBus)->postOpenViewport(app_name, x, y, w, h);
+        });
+
+        this->routes_.routeString("/tll/viewport/close", [](const char* app_name)
+        {
+            TLL_ENGINE(CommandBus)->postCloseViewport(app_name);
+        });
+    }
+
     void OscHandler::ProcessMessage(const osc::ReceivedMessage& msg, const IpEndpointName& remote_end_pt)
     {
         if (!this->app_ref)
@@ -61,14 +274,10 @@ namespace tll
 
         try
         {
-            if (strcmp(msg.AddressPattern(), "/tll/switch") == 0)
-            {
-                this->app_ref->switchApp(msg.ArgumentsBegin()->AsString());
-            }
-            else
-            {
-                this->app_ref->getRunningApp()->procOscMessage(msg);
-            }
+            if (this->routes_.dispatch(msg))
+                return;
+
+            this->app_ref->procOscMessage(msg);
         }
         catch(const std::exception& e)
         {
@@ -76,11 +285,10 @@ namespace tll
         }
     }
 
-    void runOscReceiveThread(class BaseApp* base_app)
+    void startOscReceive(class BaseApp* base_app)
     {
-        OscHandler osc_handler(base_app);
-        UdpListeningReceiveSocket osc_sock(IpEndpointName(IpEndpointName::ANY_ADDRESS, 44101), &osc_handler);
-        osc_sock.Run();
+        // 受信スレッドからプロセス終了まで参照されるため解放しない
+        UdpReactor::get()->listen(44101, new OscHandler(base_app));
     }
 
 }
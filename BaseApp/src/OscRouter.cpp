@@ -0,0 +1,389 @@
+/**
+ * @file    OscRouter.cpp
+ * @brief   OSC address pattern routing
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#include "OscRouter.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+
+namespace tll
+{
+
+    namespace
+    {
+        size_t hashAddress(std::string_view address)
+        {
+            return std::hash<std::string_view>{}(address);
+        }
+    }
+
+    uint16_t OscRouter::route(const std::string& pattern, Handler handler)
+    {
+        std::vector<Segment> segments = compile(pattern);
+        bool wildcard = pattern.find_first_of("?*[{") != std::string::npos;
+
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        Route r{ true, wildcard, ++this->serial_, pattern, std::move(segments), std::make_shared<const Handler>(std::move(handler)) };
+
+        uint16_t id;
+        if (!this->free_ids_.empty())
+        {
+            id = this->free_ids_.back();
+            this->free_ids_.pop_back();
+            this->routes_[id - 1] = std::move(r);
+        }
+        else if (this->routes_.size() < UINT16_MAX)
+        {
+            this->routes_.push_back(std::move(r));
+            id = static_cast<uint16_t>(this->routes_.size());
+        }
+        else
+        {
+            std::cerr << "[ERROR] Too many OSC routes: " << pattern << std::endl;
+            return NONE;
+        }
+
+        if (wildcard)
+            this->wildcards_.push_back(id);
+        else
+            this->exact_.emplace(hashAddress(pattern), id);
+
+        return id;
+    }
+
+    uint16_t OscRouter::routeInt32(const std::string& pattern, std::function<void(int32_t value)> handler)
+    {
+        return this->route(pattern, [handler](const osc::ReceivedMessage& msg)
+        {
+            // 型が一致しないメッセージは捨てる
+            if (msg.ArgumentCount() < 1 || !msg.ArgumentsBegin()->IsInt32())
+                return;
+
+            handler(msg.ArgumentsBegin()->AsInt32Unchecked());
+        });
+    }
+
+    uint16_t OscRouter::routeFloat(const std::string& pattern, std::function<void(float value)> handler)
+    {
+        return this->route(pattern, [handler](const osc::ReceivedMessage& msg)
+        {
+            if (msg.ArgumentCount() < 1 || !msg.ArgumentsBegin()->IsFloat())
+                return;
+
+            handler(msg.ArgumentsBegin()->AsFloatUnchecked());
+        });
+    }
+
+    uint16_t OscRouter::routeString(const std::string& pattern, std::function<void(const char* value)> handler)
+    {
+        return this->route(pattern, [handler](const osc::ReceivedMessage& msg)
+        {
+            if (msg.ArgumentCount() < 1 || !msg.ArgumentsBegin()->IsString())
+                return;
+
+            handler(msg.ArgumentsBegin()->AsStringUnchecked());
+        });
+    }
+
+    void OscRouter::remove(uint16_t id)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        if (id == NONE || id > this->routes_.size())
+            return;
+
+        Route& r = this->routes_[id - 1];
+        if (!r.active)
+            return;
+
+        r.active  = false;
+        r.handler = nullptr;
+        this->free_ids_.push_back(id);
+
+        if (r.wildcard)
+        {
+            this->wildcards_.erase(std::remove(this->wildcards_.begin(), this->wildcards_.end(), id), this->wildcards_.end());
+        }
+        else
+        {
+            auto range = this->exact_.equal_range(hashAddress(r.pattern));
+            for (auto it = range.first; it != range.second; ++it)
+            {
+                if (it->second == id)
+                {
+                    this->exact_.erase(it);
+                    break;
+                }
+            }
+        }
+    }
+
+    void OscRouter::clear()
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        this->routes_.clear();
+        this->free_ids_.clear();
+        this->exact_.clear();
+        this->wildcards_.clear();
+    }
+
+    bool OscRouter::empty()
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        return this->exact_.empty() && this->wildcards_.empty();
+    }
+
+    bool OscRouter::dispatch(const osc::ReceivedMessage& msg)
+    {
+        const char* address = msg.AddressPattern();
+
+        // 一致したルートはIDと登録番号だけを控えておく（メッセージごとに確保・コピーしない）
+        struct Match
+        {
+            uint16_t id;
+            uint32_t serial;
+        };
+        Match matches[MAX_MATCHES];
+        size_t count = 0;
+        bool overflow = false;
+
+        {
+            std::lock_guard<std::mutex> lock(this->mutex_);
+
+            auto add = [&](uint16_t id)
+            {
+                if (count < MAX_MATCHES)
+                    matches[count++] = Match{ id, this->routes_[id - 1].serial };
+                else
+                    overflow = true;
+            };
+
+            auto range = this->exact_.equal_range(hashAddress(address));
+            for (auto it = range.first; it != range.second; ++it)
+            {
+                if (this->routes_[it->second - 1].pattern == address)
+                    add(it->second);
+            }
+
+            for (uint16_t id : this->wildcards_)
+            {
+                if (match(this->routes_[id - 1], address))
+                    add(id);
+            }
+        }
+
+        if (overflow)
+            std::cerr << "[ERROR] Too many OSC routes match: " << address << std::endl;
+
+        // ハンドラ内からルートを登録・解除できるようロック外で呼び出す
+        for (size_t i = 0; i < count; i++)
+        {
+            std::shared_ptr<const Handler> handler;
+
+            {
+                std::lock_guard<std::mutex> lock(this->mutex_);
+
+                // 先に呼んだハンドラで解除（または別のルートに再利用）されたものは飛ばす
+                if (matches[i].id > this->routes_.size())
+                    continue;
+
+                const Route& r = this->routes_[matches[i].id - 1];
+                if (!r.active || r.serial != matches[i].serial)
+                    continue;
+
+                handler = r.handler;
+            }
+
+            if (*handler)
+                (*handler)(msg);
+        }
+
+        return count > 0;
+    }
+
+    std::vector<OscRouter::Segment> OscRouter::compile(const std::string& pattern)
+    {
+        std::vector<Segment> segments;
+
+        size_t pos = (!pattern.empty() && pattern[0] == '/') ? 1 : 0;
+        while (true)
+        {
+            size_t end = pattern.find('/', pos);
+            std::string part = pattern.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+
+            Segment segment;
+            size_t i = 0;
+            while (i < part.size())
+            {
+                char c = part[i];
+
+                if (c == '?')
+                {
+                    segment.push_back(Token{ EToken::ANY_CHAR, false, "", {} });
+                    i++;
+                }
+                else if (c == '*')
+                {
+                    // 連続する * は1つにまとめる
+                    if (segment.empty() || segment.back().type != EToken::ANY_STRING)
+                        segment.push_back(Token{ EToken::ANY_STRING, false, "", {} });
+                    i++;
+                }
+                else if (c == '[')
+                {
+                    size_t close = part.find(']', i + 1);
+                    if (close == std::string::npos)
+                        close = part.size();
+
+                    Token t{ EToken::CHAR_SET, false, "", {} };
+                    size_t j = i + 1;
+                    if (j < close && part[j] == '!')
+                    {
+                        t.negate = true;
+                        j++;
+                    }
+
+                    // 範囲指定は文字集合に展開しておく
+                    for (; j < close; j++)
+                    {
+                        if (j + 2 < close && part[j + 1] == '-')
+                        {
+                            char lo = std::min(part[j], part[j + 2]);
+                            char hi = std::max(part[j], part[j + 2]);
+                            for (int ch = lo; ch <= hi; ch++)
+                                t.chars.push_back(static_cast<char>(ch));
+                            j += 2;
+                        }
+                        else
+                        {
+                            t.chars.push_back(part[j]);
+                        }
+                    }
+
+                    segment.push_back(std::move(t));
+                    i = close + 1;
+                }
+                else if (c == '{')
+                {
+                    size_t close = part.find('}', i + 1);
+                    if (close == std::string::npos)
+                        close = part.size();
+
+                    Token t{ EToken::ALTERNATIVES, false, "", {} };
+                    size_t start = i + 1;
+                    while (start <= close)
+                    {
+                        size_t comma = part.find(',', start);
+                        if (comma == std::string::npos || comma > close)
+                            comma = close;
+
+                        t.words.push_back(part.substr(start, comma - start));
+                        start = comma + 1;
+                    }
+
+                    segment.push_back(std::move(t));
+                    i = close + 1;
+                }
+                else
+                {
+                    if (segment.empty() || segment.back().type != EToken::LITERAL)
+                        segment.push_back(Token{ EToken::LITERAL, false, "", {} });
+
+                    segment.back().chars.push_back(c);
+                    i++;
+                }
+            }
+
+            segments.push_back(std::move(segment));
+
+            if (end == std::string::npos)
+                break;
+            pos = end + 1;
+        }
+
+        return segments;
+    }
+
+    bool OscRouter::matchSegment(const Segment& segment, size_t token, const char* str, size_t len)
+    {
+        if (token == segment.size())
+            return len == 0;
+
+        const Token& t = segment[token];
+
+        switch (t.type)
+        {
+        case EToken::LITERAL:
+            if (len < t.chars.size() || std::memcmp(str, t.chars.data(), t.chars.size()) != 0)
+                return false;
+            return matchSegment(segment, token + 1, str + t.chars.size(), len - t.chars.size());
+
+        case EToken::ANY_CHAR:
+            if (len == 0)
+                return false;
+            return matchSegment(segment, token + 1, str + 1, len - 1);
+
+        case EToken::ANY_STRING:
+            // 最後の * は残り全てに一致する
+            if (token + 1 == segment.size())
+                return true;
+
+            for (size_t n = 0; n <= len; n++)
+            {
+                if (matchSegment(segment, token + 1, str + n, len - n))
+                    return true;
+            }
+            return false;
+
+        case EToken::CHAR_SET:
+            if (len == 0 || (t.chars.find(str[0]) != std::string::npos) == t.negate)
+                return false;
+            return matchSegment(segment, token + 1, str + 1, len - 1);
+
+        case EToken::ALTERNATIVES:
+            for (const auto& w : t.words)
+            {
+                if (len >= w.size() && std::memcmp(str, w.data(), w.size()) == 0
+                    && matchSegment(segment, token + 1, str + w.size(), len - w.size()))
+                    return true;
+            }
+            return false;
+        }
+
+        return false;
+    }
+
+    bool OscRouter::match(const Route& route, const char* address)
+    {
+        if (*address == '/')
+            address++;
+
+        // ワイルドカードは '/' をまたがないので、階層ごとに照合する
+        for (size_t i = 0; i < route.segments.size(); i++)
+        {
+            const char* end = std::strchr(address, '/');
+            size_t len = end ? static_cast<size_t>(end - address) : std::strlen(address);
+
+            bool last = (i + 1 == route.segments.size());
+            if (last != (end == nullptr))
+                return false;
+
+            if (!matchSegment(route.segments[i], 0, address, len))
+                return false;
+
+            address += len + 1;
+        }
+
+        return true;
+    }
+
+}
@@ -7,6 +7,7 @@
 
 #include "PanelManager.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <cstdlib>
 
@@ -15,6 +16,79 @@
 namespace tll
 {
 
+    namespace
+    {
+        /* 書き込み先からはみ出す部分を切り取った範囲（書き込み先の座標） */
+        struct ClipRect
+        {
+            int32_t left;
+            int32_t top;
+            int32_t right;
+            int32_t bottom;
+
+            bool empty() const noexcept { return this->left >= this->right || this->top >= this->bottom; }
+        };
+
+        ClipRect clip(int32_t x, int32_t y, uint16_t src_width, uint16_t src_height, uint16_t width, uint16_t height) noexcept
+        {
+            return ClipRect{
+                std::max<int32_t>(x, 0),
+                std::max<int32_t>(y, 0),
+                std::min<int32_t>(x + src_width,  width),
+                std::min<int32_t>(y + src_height, height)
+            };
+        }
+
+        // 切り取った範囲を1行ずつコピーする
+        void copyRows(Color* dst, uint16_t width, int32_t x, int32_t y, const SurfaceView& surface, const ClipRect& rect) noexcept
+        {
+            for (int32_t Y = rect.top; Y < rect.bottom; Y++)
+            {
+                const Color* src = &surface.pixels[(Y - y) * surface.width + (rect.left - x)];
+                std::copy(src, src + (rect.right - rect.left), &dst[Y * width + rect.left]);
+            }
+        }
+
+        // マスクの1行のうち[begin, end)の範囲で、1が連続する区間ごとにfill(開始, 終了)を呼ぶ
+        template<class F>
+        void forEachSpan(const uint64_t* row, int32_t begin, int32_t end, F&& fill)
+        {
+            int32_t i = begin;
+
+            while (i < end)
+            {
+                // 0の区間を読み飛ばす
+                uint64_t word = row[i >> 6] >> (i & 63);
+                if (word == 0)
+                {
+                    i = (i | 63) + 1;
+                    continue;
+                }
+                i += __builtin_ctzll(word);
+                if (i >= end)
+                    break;
+
+                // 1の区間の終わりを探す
+                int32_t start = i;
+                while (i < end)
+                {
+                    uint64_t inverted = ~row[i >> 6] >> (i & 63);
+                    if (inverted == 0)
+                    {
+                        i = (i | 63) + 1;
+                        continue;
+                    }
+                    i += __builtin_ctzll(inverted);
+                    break;
+                }
+
+                fill(start, std::min(i, end));
+            }
+        }
+    }
+
+    thread_local Surface* IPanelManager::render_target_ = nullptr;
+
     IPanelManager* IPanelManager::create()
     {
         return new PanelManager();
@@ -42,23 +116,43 @@ namespace tll
         }
     }
 
+    inline Color* PanelManager::target(uint16_t& width, uint16_t& height) noexcept
+    {
+        if (render_target_)
+        {
+            width  = render_target_->width;
+            height = render_target_->height;
+            return render_target_->pixels.data();
+        }
+
+        width  = this->width_;
+        height = this->height_;
+        return this->color_.data();
+    }
+
     inline void PanelManager::drawPixel(uint16_t x, uint16_t y, Color c) noexcept
     {
-        if (x >= this->width_ || y >= this->height_)
+        uint16_t width, height;
+        Color* pixels = this->target(width, height);
+
+        if (x >= width || y >= height)
             return;
 
-        this->color_[y * width_ + x] = c;
+        pixels[y * width + x] = c;
     }
 
     void PanelManager::drawRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, Color c) noexcept
     {
+        uint16_t width, height;
+        Color* pixels = this->target(width, height);
+
         for (int i = 0; i < h; i++)
         {
             for (int j = 0; j < w; j++)
             {
-                if ((x + j) < width_ && (y + i) < height_)
+                if ((x + j) < width && (y + i) < height)
                 {
-                    color_[(y + i) * width_ + (x + j)] = c;
+                    pixels[(y + i) * width + (x + j)] = c;
                 }
             }
         }
@@ -146,12 +240,83 @@ namespace tll
 
     void PanelManager::clear() noexcept
     {
-        for (int y = 0; y < height_; y++)
+        uint16_t width, height;
+        Color* pixels = this->target(width, height);
+
+        std::fill(pixels, pixels + width * height, Color());
+    }
+
+    void PanelManager::blit(int32_t x, int32_t y, const Surface& surface) noexcept
+    {
+        // パネルからはみ出す部分を切り取って1行ずつコピーする
+        ClipRect rect = clip(x, y, surface.width, surface.height, this->width_, this->height_);
+        if (rect.empty())
+            return;
+
+        copyRows(this->color_.data(), this->width_, x, y, surface, rect);
+    }
+
+    void PanelManager::drawSurface(int32_t x, int32_t y, const SurfaceView& surface) noexcept
+    {
+        uint16_t width, height;
+        Color* pixels = this->target(width, height);
+
+        ClipRect rect = clip(x, y, surface.width, surface.height, width, height);
+        if (rect.empty())
+            return;
+
+        copyRows(pixels, width, x, y, surface, rect);
+    }
+
+    void PanelManager::drawSurfaceMasked(int32_t x, int32_t y, const SurfaceView& surface, const MaskView& mask) noexcept
+    {
+        uint16_t width, height;
+        Color* pixels = this->target(width, height);
+
+        ClipRect rect = clip(x, y, surface.width, surface.height, width, height);
+        if (rect.empty())
+            return;
+
+        // 1の区間だけをコピーし、0のピクセルは描画先の色を残す
+        int32_t left = rect.left - x;    // 切り取った範囲の左端（画像の座標）
+        for (int32_t Y = rect.top; Y < rect.bottom; Y++)
         {
-            for (int x = 0; x < width_; x++)
+            const Color* src = &surface.pixels[(Y - y) * surface.width];
+            Color* dst = &pixels[Y * width + rect.left];
+
+            forEachSpan(mask.row(Y - y), left, rect.right - x, [&](int32_t begin, int32_t end)
             {
-                color_[y * width_ + x] = Color();
-            }
+                std::copy(src + begin, src + end, dst + (begin - left));
+            });
+        }
+    }
+
+    void PanelManager::drawMask(int32_t x, int32_t y, const MaskView& mask, Color color, bool transparent) noexcept
+    {
+        uint16_t width, height;
+        Color* pixels = this->target(width, height);
+
+        ClipRect rect = clip(x, y, mask.width, mask.height, width, height);
+        if (rect.empty())
+            return;
+
+        int32_t left = rect.left - x;    // 切り取った範囲の左端（マスクの座標）
+        for (int32_t Y = rect.top; Y < rect.bottom; Y++)
+        {
+            Color* dst = &pixels[Y * width + rect.left];
+            int32_t filled = left;
+
+            forEachSpan(mask.row(Y - y), left, rect.right - x, [&](int32_t begin, int32_t end)
+            {
+                if (!transparent)
+                    std::fill(dst + (filled - left), dst + (begin - left), Color());
+
+                std::fill(dst + (begin - left), dst + (end - left), color);
+                filled = end;
+            });
+
+            if (!transparent)
+                std::fill(dst + (filled - left), dst + (rect.right - rect.left), Color());
         }
     }
 
@@ -0,0 +1,483 @@
+/**
+ * @file    RemoteApp.cpp
+ * @brief   Out-of-process app hosting over shared memory
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#include "RemoteApp.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include <dirent.h>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "tllEngine.hpp"
+#include "Common.hpp"
+#include "Event.hpp"
+#include "TextRenderer.hpp"
+
+extern char** environ;
+
+namespace tll
+{
+
+    namespace
+    {
+        // 子プロセスでのイベント通知・親プロセスの監視用のファイルディスクリプタ番号
+        constexpr int CHILD_EVENT_FD  = 3;
+        constexpr int CHILD_PARENT_FD = 4;
+
+        // 子プロセスに渡す前の一時的な番号（dup2先の番号と重ならないようにする）
+        constexpr int SPAWN_FD_BASE = 10;
+
+        // 指定番号以降のファイルディスクリプタを全て閉じる（親から意図せず引き継いだものを残さない）
+        void closeFrom(int first)
+        {
+            std::vector<int> fds;
+
+            DIR* dir = opendir("/proc/self/fd");
+            if (!dir)
+                return;
+
+            while (struct dirent* ent = readdir(dir))
+            {
+                int fd = std::atoi(ent->d_name);
+                if (fd >= first && fd != dirfd(dir))
+                    fds.push_back(fd);
+            }
+            closedir(dir);
+
+            for (int fd : fds)
+                close(fd);
+        }
+    }
+
+    namespace remote
+    {
+        size_t sharedSize(uint16_t width, uint16_t height)
+        {
+            return sizeof(SharedFrame) + sizeof(Color) * width * height * 3;
+        }
+
+        Color* pixels(SharedFrame* shared, uint32_t index)
+        {
+            Color* base = reinterpret_cast<Color*>(reinterpret_cast<uint8_t*>(shared) + sizeof(SharedFrame));
+            return base + static_cast<size_t>(shared->width) * shared->height * index;
+        }
+    }
+
+    RemoteApp::RemoteApp(std::string app_path, std::string symbol) noexcept
+        : app_path_(app_path)
+        , symbol_(symbol)
+        , shared_(nullptr)
+        , shared_size_(0)
+        , event_fd_(-1)
+        , parent_fd_(-1)
+        , pid_(-1)
+        , exited_(false)
+        , read_index_(2)
+    {
+    }
+
+    RemoteApp::~RemoteApp()
+    {
+        this->terminate();
+    }
+
+    void RemoteApp::init()
+    {
+        static std::atomic<uint32_t> count{0};
+
+        // 描画先（パネル、またはビューポート）と同じ大きさのバッファを共有する
+        uint16_t width  = TLL_ENGINE(PanelManager)->getWidth();
+        uint16_t height = TLL_ENGINE(PanelManager)->getHeight();
+        this->frame_.resize(width, height);
+
+        this->shm_name_ = "/tll_app_" + std::to_string(getpid()) + "_" + std::to_string(count++);
+        this->shared_size_ = remote::sharedSize(width, height);
+
+        int fd = shm_open(this->shm_name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0 || ftruncate(fd, this->shared_size_) < 0)
+        {
+            std::cerr << "[ERROR] Failed to create shared memory: " << strerror(errno) << std::endl;
+            if (fd >= 0)
+                close(fd);
+            return;
+        }
+
+        void* addr = mmap(nullptr, this->shared_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (addr == MAP_FAILED)
+        {
+            std::cerr << "[ERROR] Failed to map shared memory: " << strerror(errno) << std::endl;
+            shm_unlink(this->shm_name_.c_str());
+            return;
+        }
+
+        // ftruncateした領域は0で埋まっている（全バッファが黒）
+        this->shared_ = new (addr) remote::SharedFrame();
+        this->shared_->magic  = remote::MAGIC;
+        this->shared_->width  = width;
+        this->shared_->height = height;
+        this->shared_->stop   = 0;
+        this->shared_->touched_num = 0;
+        this->shared_->latest = 1;    // 子は0番に描画し、親は2番から読み出す
+        this->shared_->frames = 0;
+        this->shared_->ring_head = 0;
+        this->shared_->ring_tail = 0;
+
+        // 他の子プロセスに引き継がれないよう、全てCLOEXECで作成し、この子プロセスにだけdup2で渡す
+        // 親の生存はパイプで知らせる（親が終了すると書き込み側が閉じられ、子がPOLLHUPを受け取る）
+        // PR_SET_PDEATHSIGは起動したスレッドの終了で発火するため、準備用の短命なスレッドから起動する場合に使えない
+        int pipe_fds[2];
+        this->event_fd_ = eventfd(0, EFD_CLOEXEC);
+        if (this->event_fd_ < 0 || pipe2(pipe_fds, O_CLOEXEC) < 0)
+        {
+            std::cerr << "[ERROR] Failed to create app process channel: " << strerror(errno) << std::endl;
+            return;
+        }
+        this->parent_fd_ = pipe_fds[1];
+
+        int event_src  = fcntl(this->event_fd_, F_DUPFD_CLOEXEC, SPAWN_FD_BASE);
+        int parent_src = fcntl(pipe_fds[0], F_DUPFD_CLOEXEC, SPAWN_FD_BASE);
+        close(pipe_fds[0]);
+
+        std::string event_fd_str  = std::to_string(CHILD_EVENT_FD);
+        std::string parent_fd_str = std::to_string(CHILD_PARENT_FD);
+        char* argv[] = {
+            const_cast<char*>("/proc/self/exe"),
+            const_cast<char*>("--app-host"),
+            const_cast<char*>(this->app_path_.c_str()),
+            const_cast<char*>(this->symbol_.c_str()),
+            const_cast<char*>(this->shm_name_.c_str()),
+            const_cast<char*>(event_fd_str.c_str()),
+            const_cast<char*>(parent_fd_str.c_str()),
+            nullptr
+        };
+
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_adddup2(&actions, event_src, CHILD_EVENT_FD);
+        posix_spawn_file_actions_adddup2(&actions, parent_src, CHILD_PARENT_FD);
+
+        if (event_src < 0 || parent_src < 0
+            || posix_spawn(&this->pid_, "/proc/self/exe", &actions, nullptr, argv, environ) != 0)
+        {
+            std::cerr << "[ERROR] Failed to start app process: " << this->app_path_ << std::endl;
+            this->pid_ = -1;
+        }
+
+        posix_spawn_file_actions_destroy(&actions);
+        if (event_src >= 0)
+            close(event_src);
+        if (parent_src >= 0)
+            close(parent_src);
+    }
+
+    void RemoteApp::run()
+    {
+        if (!this->shared_)
+            return;
+
+        // 子プロセスが異常終了した場合は最後のフレームを表示し続ける
+        if (this->pid_ > 0 && !this->exited_)
+        {
+            int status;
+            if (waitpid(this->pid_, &status, WNOHANG) == this->pid_)
+            {
+                this->exited_ = true;
+                std::cerr << "[ERROR] App process exited: " << this->app_path_ << std::endl;
+            }
+        }
+
+        // 新しいフレームがあれば読み出し用のバッファと入れ替える
+        if (this->shared_->latest.load(std::memory_order_acquire) & remote::NEW_FRAME)
+        {
+            this->read_index_ = this->shared_->latest.exchange(this->read_index_, std::memory_order_acq_rel) & remote::INDEX_MASK;
+
+            const Color* src = remote::pixels(this->shared_, this->read_index_);
+            std::copy(src, src + this->frame_.pixels.size(), this->frame_.pixels.begin());
+        }
+
+        Surface* target = IPanelManager::getRenderTarget();
+        if (target)
+            std::copy(this->frame_.pixels.begin(), this->frame_.pixels.end(), target->pixels.begin());
+        else
+            TLL_ENGINE(PanelManager)->blit(0, 0, this->frame_);
+
+        // 子プロセスではタッチ点を管理していないため、描画前に親の値を渡しておく
+        this->shared_->touched_num.store(TLL_ENGINE(EventHandler)->getTouchedNum(), std::memory_order_relaxed);
+
+        // 子プロセスに次のフレームの描画を促す（描画が遅れている場合は通知がまとめられる）
+        uint64_t one = 1;
+        (void)!write(this->event_fd_, &one, sizeof(one));
+    }
+
+    void RemoteApp::terminate()
+    {
+        if (this->pid_ > 0)
+        {
+            this->shared_->stop = 1;
+
+            uint64_t one = 1;
+            (void)!write(this->event_fd_, &one, sizeof(one));
+
+            // 終了しない場合は強制終了する
+            int status;
+            pid_t result = 0;
+            for (int i = 0; i < 50 && result == 0 && !this->exited_; i++)
+            {
+                result = waitpid(this->pid_, &status, WNOHANG);
+                if (result == 0)
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+
+            if (result == 0 && !this->exited_)
+            {
+                kill(this->pid_, SIGKILL);
+                waitpid(this->pid_, &status, 0);
+            }
+
+            this->pid_ = -1;
+        }
+
+        if (this->shared_)
+        {
+            munmap(this->shared_, this->shared_size_);
+            shm_unlink(this->shm_name_.c_str());
+            this->shared_ = nullptr;
+        }
+
+        if (this->event_fd_ >= 0)
+        {
+            close(this->event_fd_);
+            this->event_fd_ = -1;
+        }
+
+        if (this->parent_fd_ >= 0)
+        {
+            close(this->parent_fd_);
+            this->parent_fd_ = -1;
+        }
+    }
+
+    void RemoteApp::onTouched(TouchInfo ti)
+    {
+        this->push(remote::Event{ remote::EEvent::TOUCHED, ti, {}, 0, 0, 0, 0, 0 });
+    }
+
+    void RemoteApp::onMoved(TouchInfo ti)
+    {
+        this->push(remote::Event{ remote::EEvent::MOVED, ti, {}, 0, 0, 0, 0, 0 });
+    }
+
+    void RemoteApp::onReleased(TouchInfo ti)
+    {
+        this->push(remote::Event{ remote::EEvent::RELEASED, ti, {}, 0, 0, 0, 0, 0 });
+    }
+
+    void RemoteApp::onGesture(GestureInfo gi)
+    {
+        this->push(remote::Event{ remote::EEvent::GESTURE, TouchInfo{ 0, 0, 0 }, gi, 0, 0, 0, 0, 0 });
+    }
+
+    void RemoteApp::addBlob(BlobInfo bi)
+    {
+        this->push(makeBlobEvent(remote::EEvent::BLOB_ADDED, bi));
+    }
+
+    void RemoteApp::moveBlob(BlobInfo bi)
+    {
+        this->push(makeBlobEvent(remote::EEvent::BLOB_MOVED, bi));
+    }
+
+    void RemoteApp::removeBlob(BlobInfo bi)
+    {
+        this->push(makeBlobEvent(remote::EEvent::BLOB_REMOVED, bi));
+    }
+
+    remote::Event RemoteApp::makeBlobEvent(remote::EEvent type, const BlobInfo& bi)
+    {
+        return remote::Event{ type, TouchInfo{ 0, 0, 0 }, {}, bi.id, bi.x, bi.y, bi.w, bi.h };
+    }
+
+    void RemoteApp::push(remote::Event ev)
+    {
+        std::lock_guard<std::mutex> lock(this->push_mutex_);
+
+        if (!this->shared_)
+            return;
+
+        uint32_t tail = this->shared_->ring_tail.load(std::memory_order_relaxed);
+        uint32_t head = this->shared_->ring_head.load(std::memory_order_acquire);
+        if (tail - head >= remote::RING_SIZE)
+        {
+            TLL_ENGINE(EventHandler)->countDropped();
+            return;
+        }
+
+        this->shared_->ring[tail & (remote::RING_SIZE - 1)] = ev;
+        this->shared_->ring_tail.store(tail + 1, std::memory_order_release);
+    }
+
+    int runAppHost(const char* app_path, const char* symbol, const char* shm_name, int event_fd, int parent_fd)
+    {
+        // 渡されたもの以外に引き継いだファイルディスクリプタを閉じる
+        closeFrom(std::max(event_fd, parent_fd) + 1);
+
+        int fd = shm_open(shm_name, O_RDWR, 0);
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) < 0)
+        {
+            std::cerr << "[ERROR] Failed to open shared memory: " << shm_name << std::endl;
+            return 1;
+        }
+
+        // ヘッダを読む前に大きさを確かめる（親が作成途中、または別の領域の場合）
+        if (st.st_size < static_cast<off_t>(sizeof(remote::SharedFrame)))
+        {
+            std::cerr << "[ERROR] Shared memory is too small: " << shm_name << std::endl;
+            close(fd);
+            return 1;
+        }
+
+        void* addr = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (addr == MAP_FAILED)
+            return 1;
+
+        // ヘッダの大きさに対してピクセルバッファが収まっているかも確かめる
+        remote::SharedFrame* shared = static_cast<remote::SharedFrame*>(addr);
+        if (shared->magic != remote::MAGIC
+            || static_cast<size_t>(st.st_size) < remote::sharedSize(shared->width, shared->height))
+        {
+            std::cerr << "[ERROR] Invalid shared memory: " << shm_name << std::endl;
+            munmap(addr, st.st_size);
+            return 1;
+        }
+
+        // パスが無い場合は静的リンクされたアプリを名前で探す
+        void* handle = nullptr;
+        createApp* createAppFunc = nullptr;
+        if (*app_path == '\0')
+            createAppFunc = AppRegistry::find(symbol);
+        else if ((handle = dlopen(app_path, RTLD_LAZY)) != nullptr)
+            createAppFunc = (createApp*)(dlsym(handle, symbol));
+
+        if (!createAppFunc)
+        {
+            std::cerr << "[ERROR] Failed to load app: " << (*app_path != '\0' ? app_path : symbol) << std::endl;
+            return 1;
+        }
+
+        // 描画に必要なコンポーネントだけを初期化する（出力・入力は親プロセスが担う）
+        uint16_t width  = shared->width;
+        uint16_t height = shared->height;
+        tllEngine::get();
+        TLL_ENGINE(PanelManager)->init(width, height);
+        TLL_ENGINE(TextRenderer)->init();
+        TLL_ENGINE(EventHandler)->mirrorTouchedNum(&shared->touched_num);
+
+        Surface surface;
+        surface.resize(width, height);
+        IPanelManager::setRenderTarget(&surface);
+
+        std::unique_ptr<AppInterface> app = createAppFunc();
+        app->getTouchRegions().init(width, height);
+        app->init();
+
+        uint32_t draw_index = 0;
+
+        while (!shared->stop)
+        {
+            struct pollfd pfds[2] = {
+                { event_fd,  POLLIN, 0 },
+                { parent_fd, POLLIN, 0 },
+            };
+            if (poll(pfds, 2, 500) <= 0)
+                continue;
+
+            // 親プロセスが落ちた場合は一緒に終了する
+            if (pfds[1].revents != 0)
+                break;
+
+            if ((pfds[0].revents & POLLIN) == 0)
+                continue;
+
+            uint64_t count;
+            (void)!read(event_fd, &count, sizeof(count));
+            if (shared->stop)
+                break;
+
+            // フレームの開始時に溜まったイベントを配送する
+            uint32_t head = shared->ring_head.load(std::memory_order_relaxed);
+            uint32_t tail = shared->ring_tail.load(std::memory_order_acquire);
+            for (; head != tail; head++)
+            {
+                const remote::Event& ev = shared->ring[head & (remote::RING_SIZE - 1)];
+                BlobInfo bi{ ev.blob_id, ev.blob_x, ev.blob_y, ev.blob_w, ev.blob_h };
+
+                switch (ev.type)
+                {
+                case remote::EEvent::TOUCHED:
+                    app->getTouchRegions().dispatch(ETouchEvent::TOUCHED, ev.ti);
+                    app->onTouched(ev.ti);
+                    break;
+                case remote::EEvent::MOVED:
+                    app->getTouchRegions().dispatch(ETouchEvent::MOVED, ev.ti);
+                    app->onMoved(ev.ti);
+                    break;
+                case remote::EEvent::RELEASED:
+                    app->getTouchRegions().dispatch(ETouchEvent::RELEASED, ev.ti);
+                    app->onReleased(ev.ti);
+                    break;
+                case remote::EEvent::BLOB_ADDED:   app->addBlob(bi);        break;
+                case remote::EEvent::BLOB_MOVED:   app->moveBlob(bi);       break;
+                case remote::EEvent::BLOB_REMOVED: app->removeBlob(bi);     break;
+                case remote::EEvent::GESTURE:      app->onGesture(ev.gi);   break;
+                }
+            }
+            shared->ring_head.store(head, std::memory_order_release);
+
+            // 予算の監視は親プロセスで行うため、期限は既定（無し）のまま番号と所要時間だけ更新する
+            FrameContext& ctx = app->getFrameContext();
+            auto start = std::chrono::steady_clock::now();
+
+            app->run();
+
+            ctx.frame++;
+            ctx.last_us = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+
+            // 描画し終えたバッファを最新のフレームとして公開する
+            std::copy(surface.pixels.begin(), surface.pixels.end(), remote::pixels(shared, draw_index));
+            draw_index = shared->latest.exchange(draw_index | remote::NEW_FRAME, std::memory_order_acq_rel) & remote::INDEX_MASK;
+            shared->frames++;
+        }
+
+        app->terminate();
+        app.reset();
+        IPanelManager::setRenderTarget(nullptr);
+
+        munmap(addr, st.st_size);
+        return 0;
+    }
+
+}
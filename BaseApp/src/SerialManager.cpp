@@ -17,6 +17,7 @@
 #include "Color.hpp"
 #include "Common.hpp"
 #include "Event.hpp"
+#include "LatencyTracer.hpp"
 #include "PanelManager.hpp"
 
 #include <zmq.hpp>
@@ -45,6 +46,11 @@ namespace tll
                         continue;
                     }
 
+                    TLL_ENGINE(LatencyTracer)->beginFrame();
+
+                    // 輝度はフレームごとに1度だけ読む
+                    uint32_t brightness = TLL_ENGINE(SerialManager)->getBrightness();
+
                     std::vector<uint8_t> color_vec;    // 送信用配列
                     color_vec.reserve(TLL_ENGINE(PanelManager)->getWidth() * TLL_ENGINE(PanelManager)->getHeight() * 3);
 
@@ -53,9 +59,9 @@ namespace tll
                         for (uint16_t x = 0; x < TLL_ENGINE(PanelManager)->getWidth(); x++)
                         {
                             Color c = TLL_ENGINE(PanelManager)->getColor(x, y);
-                            color_vec.push_back(c.r_);
-                            color_vec.push_back(c.g_);
-                            color_vec.push_back(c.b_);
+                            color_vec.push_back(static_cast<uint8_t>(c.r_ * brightness / 255));
+                            color_vec.push_back(static_cast<uint8_t>(c.g_ * brightness / 255));
+                            color_vec.push_back(static_cast<uint8_t>(c.b_ * brightness / 255));
                         }
                     }
 
@@ -65,6 +71,8 @@ namespace tll
                     zmq::message_t msg(color_vec);
                     res = pub.send(msg, zmq::send_flags::none);
 
+                    TLL_ENGINE(LatencyTracer)->endFrame();
+
                     TLL_ENGINE(SerialManager)->send_ready = false;
                 }
 
@@ -10,6 +10,7 @@
 #include <chrono>
 #include <csignal>
 #include <ctime>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -17,12 +18,16 @@
 #include <thread>
 
 #include "tllEngine.hpp"
+#include "AssetManager.hpp"
 #include "Color.hpp"
 #include "Common.hpp"
 #include "Event.hpp"
+#include "LatencyTracer.hpp"
+#include "OscHandler.hpp"
 #include "PanelManager.hpp"
 #include "SerialManager.hpp"
 #include "TextRenderer.hpp"
+#include "UdpReactor.hpp"
 
 #include <opencv2/opencv.hpp>
 
@@ -48,6 +53,9 @@ namespace tll
 
         TLL_ENGINE(SerialManager)->sendColorData();
 
+        // このフレームで送られたOSCメッセージを送信先ごとにまとめて送る
+        OscHandler::flush();
+
         return !TLL_ENGINE(EventHandler)->getQuitFlag();
     }
 
@@ -106,15 +114,39 @@ namespace tll
 
     tll::Image* loadImage(const char* file)
     {
-        cv::Mat img = cv::imread(file);
-        if (img.empty())
+        // デコード済みの画像を複製する（同じファイルを読み込み直さない）
+        std::shared_ptr<const tll::Image> image = getImage(file);
+        if (!image)
+        {
             std::cout << file << " is not found." << std::endl;
+            return new tll::Image();
+        }
+
+        return new tll::Image(*image);
+    }
 
-        return new tll::Image(img);
+    std::shared_ptr<const tll::Image> getImage(const char* file, uint16_t width, uint16_t height)
+    {
+        return TLL_ENGINE(AssetManager)->getImage(file, width, height);
+    }
+
+    std::shared_ptr<const tll::AssetPack> loadPack(const char* file)
+    {
+        return TLL_ENGINE(AssetManager)->getPack(file);
     }
 
     tll::Video loadVideo(const char* file)
     {
+        // TLL_VideoTranscodeで変換済みの動画はデコードせずにマップして再生する
+        if (std::filesystem::path(file).extension() == ".tllvid")
+        {
+            auto video_file = std::make_unique<tll::VideoFile>();
+            if (!video_file->open(file))
+                return tll::Video();
+
+            return tll::Video(std::move(video_file));
+        }
+
         cv::VideoCapture video;
         video.open(file);
         if (video.isOpened() == false)
@@ -142,4 +174,17 @@ namespace tll
         return TLL_ENGINE(EventHandler)->getTouchedNum();
     }
 
+    EventStats getEventStats()
+    {
+        EventStats stats = TLL_ENGINE(EventHandler)->getStats();
+        stats.dropped += UdpReactor::get()->getDroppedPackets();
+
+        return stats;
+    }
+
+    LatencyStats getLatencyStats()
+    {
+        return TLL_ENGINE(LatencyTracer)->getStats();
+    }
+
 }
@@ -37,8 +37,6 @@ namespace tll
 
     void TextRenderer::init()
     {
-        this->ft2_ = cv::freetype::createFreeType2();
-
         this->loadFont();
     }
 
@@ -47,6 +45,11 @@ namespace tll
         uint32_t width  = TLL_ENGINE(PanelManager)->getWidth();
         uint32_t height = TLL_ENGINE(PanelManager)->getHeight();
 
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        if (!this->ft2_)
+            return;
+
         this->font_size_ = size;
 
         cv::String text = str;
@@ -79,7 +82,15 @@ namespace tll
 
     void TextRenderer::loadFont(const char* font_file_path)
     {
-        this->ft2_->loadFontData(font_file_path, 0);
+        // 読み込み済みのフォントは共有する
+        this->font_ = TLL_ENGINE(AssetManager)->getFont(font_file_path);
+        if (!this->font_)
+        {
+            std::cerr << "[ERROR] Failed to load font: " << font_file_path << std::endl;
+            return;
+        }
+
+        this->ft2_ = this->font_->ft2;
     }
 
 }
@@ -0,0 +1,178 @@
+/**
+ * @file    TouchPredictor.cpp
+ * @brief   Touch position prediction
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#include "TouchPredictor.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tll
+{
+
+    TouchPredictor::TouchPredictor() noexcept
+        : TouchPredictor(PredictorConfig())
+    {
+    }
+
+    TouchPredictor::TouchPredictor(PredictorConfig config) noexcept
+        : config_(config)
+    {
+    }
+
+    TouchInfo TouchPredictor::touch(const TouchInfo& ti)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        FilterState* fs = this->find(ti.id);
+        if (fs == nullptr)
+        {
+            for (auto& f : this->filters_)
+            {
+                if (!f.active)
+                {
+                    fs = &f;
+                    break;
+                }
+            }
+        }
+
+        // 追跡可能な点数を超えた場合は予測せずに渡す
+        if (fs == nullptr)
+        {
+            FilterState tmp;
+            tmp.x = static_cast<float>(ti.x);
+            tmp.y = static_cast<float>(ti.y);
+            return this->output(ti, tmp);
+        }
+
+        fs->active = true;
+        fs->id = ti.id;
+        fs->x  = static_cast<float>(ti.x);
+        fs->y  = static_cast<float>(ti.y);
+        fs->vx = 0.f;
+        fs->vy = 0.f;
+        fs->last_time = timeOf(ti);
+
+        return this->output(ti, *fs);
+    }
+
+    TouchInfo TouchPredictor::move(const TouchInfo& ti)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        FilterState* fs = this->find(ti.id);
+        if (fs == nullptr)
+        {
+            FilterState tmp;
+            tmp.x = static_cast<float>(ti.x);
+            tmp.y = static_cast<float>(ti.y);
+            return this->output(ti, tmp);
+        }
+
+        // 受信の間隔はまとめて受信したパケットではほぼ0になるため、センサのフレーム時刻の差を使う
+        // （同じフレームの更新で速度が発散しないよう、センサの更新周期を下限とする）
+        uint64_t now = timeOf(ti);
+        uint64_t elapsed_us = (now > fs->last_time) ? now - fs->last_time : 0;
+        fs->last_time = now;
+
+        float dt = static_cast<float>(std::max<uint64_t>(elapsed_us, std::max<uint32_t>(this->config_.sensor_period, 1))) / 1e6f;
+
+        // 予測
+        float px = fs->x + fs->vx * dt;
+        float py = fs->y + fs->vy * dt;
+
+        // 観測値との残差で位置・速度を補正
+        float rx = static_cast<float>(ti.x) - px;
+        float ry = static_cast<float>(ti.y) - py;
+
+        fs->x  = px + this->config_.alpha * rx;
+        fs->y  = py + this->config_.alpha * ry;
+        fs->vx = fs->vx + (this->config_.beta / dt) * rx;
+        fs->vy = fs->vy + (this->config_.beta / dt) * ry;
+
+        return this->output(ti, *fs);
+    }
+
+    TouchInfo TouchPredictor::release(const TouchInfo& ti)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        FilterState* fs = this->find(ti.id);
+        if (fs == nullptr)
+        {
+            FilterState tmp;
+            tmp.x = static_cast<float>(ti.x);
+            tmp.y = static_cast<float>(ti.y);
+            return this->output(ti, tmp);
+        }
+
+        fs->active = false;
+
+        // 離した位置は予測ではなく実際の座標で渡す
+        FilterState last = *fs;
+        last.x  = static_cast<float>(ti.x);
+        last.y  = static_cast<float>(ti.y);
+        last.vx = 0.f;
+        last.vy = 0.f;
+
+        return this->output(ti, last);
+    }
+
+    TouchPredictor::FilterState* TouchPredictor::find(uint32_t id)
+    {
+        for (auto& fs : this->filters_)
+        {
+            if (fs.active && fs.id == id)
+                return &fs;
+        }
+
+        return nullptr;
+    }
+
+    uint64_t TouchPredictor::timeOf(const TouchInfo& ti)
+    {
+        if (ti.frame_time != 0)
+            return ti.frame_time;
+
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count());
+    }
+
+    TouchInfo TouchPredictor::output(const TouchInfo& ti, const FilterState& fs) const
+    {
+        TouchInfo out = ti;
+        out.raw_x = ti.x;
+        out.raw_y = ti.y;
+
+        if (!this->config_.enabled)
+        {
+            out.smooth_x = static_cast<float>(ti.x);
+            out.smooth_y = static_cast<float>(ti.y);
+            return out;
+        }
+
+        out.smooth_x = fs.x;
+        out.smooth_y = fs.y;
+        out.vx = fs.vx;
+        out.vy = fs.vy;
+
+        float lookahead = static_cast<float>(this->config_.lookahead) / 1000.f;
+        out.x = static_cast<int32_t>(std::lround(fs.x + fs.vx * lookahead));
+        out.y = static_cast<int32_t>(std::lround(fs.y + fs.vy * lookahead));
+
+        // 速く動かした際にパネルの外を指さないようにする
+        if (this->config_.width > 0 && this->config_.height > 0)
+        {
+            out.x = std::clamp<int32_t>(out.x, 0, this->config_.width  - 1);
+            out.y = std::clamp<int32_t>(out.y, 0, this->config_.height - 1);
+        }
+
+        return out;
+    }
+
+}
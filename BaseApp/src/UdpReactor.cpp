@@ -0,0 +1,303 @@
+/**
+ * @file    UdpReactor.cpp
+ * @brief   Single-threaded UDP receive loop for all OSC/TUIO ports
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#include "UdpReactor.hpp"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "ip/IpEndpointName.h"
+
+#include "Common.hpp"
+
+namespace tll
+{
+
+    namespace
+    {
+        // 1回のrecvmmsgで受け取るパケット数
+        constexpr int BATCH_SIZE = 16;
+
+        // 1パケットの最大サイズ
+        constexpr int PACKET_SIZE = 8192;
+
+        // 1回の通知で受信する最大のバッチ数（残りは次のepoll_waitで受け取り、他のソケットや登録解除を待たせない）
+        constexpr int MAX_BATCHES = 4;
+    }
+
+    UdpReactor::UdpReactor()
+        : unlisten_seq_(0)
+        , ack_seq_(0)
+        , stop_(false)
+    {
+        this->epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+        this->wake_fd_  = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+        struct epoll_event ev = {};
+        ev.events   = EPOLLIN;
+        ev.data.ptr = nullptr;    // 停止・登録解除の通知
+        epoll_ctl(this->epoll_fd_, EPOLL_CTL_ADD, this->wake_fd_, &ev);
+    }
+
+    UdpReactor::~UdpReactor()
+    {
+        if (this->thread_.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(this->mutex_);
+                this->stop_ = true;
+            }
+
+            uint64_t one = 1;
+            (void)!write(this->wake_fd_, &one, sizeof(one));
+            this->thread_.join();
+        }
+
+        for (auto& entry : this->entries_)
+            close(entry->fd);
+
+        close(this->wake_fd_);
+        close(this->epoll_fd_);
+    }
+
+    bool UdpReactor::listen(int port, PacketListener* listener)
+    {
+        int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+            return false;
+
+        struct sockaddr_in addr = {};
+        addr.sin_family      = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port        = htons(port);
+
+        if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0)
+        {
+            std::cerr << "[ERROR] Failed to bind UDP port " << port << ": " << strerror(errno) << std::endl;
+            close(fd);
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        this->entries_.push_back(std::make_unique<Entry>(Entry{ fd, port, listener }));
+
+        struct epoll_event ev = {};
+        ev.events   = EPOLLIN;
+        ev.data.ptr = this->entries_.back().get();
+        epoll_ctl(this->epoll_fd_, EPOLL_CTL_ADD, fd, &ev);
+
+        if (!this->thread_.joinable())
+            this->thread_ = std::thread(&UdpReactor::run, this);
+
+        return true;
+    }
+
+    void UdpReactor::unlisten(PacketListener* listener)
+    {
+        std::vector<std::unique_ptr<Entry>> removed;
+        std::unique_lock<std::mutex> lock(this->mutex_);
+
+        // epollから外した後は、既に取り出された通知の配送だけが残る
+        for (auto it = this->entries_.begin(); it != this->entries_.end(); )
+        {
+            if ((*it)->listener != listener)
+            {
+                ++it;
+                continue;
+            }
+
+            epoll_ctl(this->epoll_fd_, EPOLL_CTL_DEL, (*it)->fd, nullptr);
+            removed.push_back(std::move(*it));
+            it = this->entries_.erase(it);
+        }
+
+        if (removed.empty())
+            return;
+
+        // 配送中のリスナ自身から解除された場合は、受信スレッドが配送を終えてから閉じる
+        if (this->thread_.joinable() && std::this_thread::get_id() == this->thread_.get_id())
+        {
+            // 同じ回に取り出した通知がこのエントリを指していても配送しない
+            for (auto& entry : removed)
+            {
+                entry->listener = nullptr;
+                this->deferred_.push_back(std::move(entry));
+            }
+            return;
+        }
+
+        // 受信スレッドが取り出し済みの通知を配送し終えるまで待つ
+        if (this->thread_.joinable() && !this->stop_)
+        {
+            uint64_t seq = ++this->unlisten_seq_;
+
+            uint64_t one = 1;
+            (void)!write(this->wake_fd_, &one, sizeof(one));
+
+            this->ack_cv_.wait(lock, [this, seq]() { return this->stop_ || this->ack_seq_ >= seq; });
+        }
+
+        lock.unlock();
+
+        for (auto& entry : removed)
+            close(entry->fd);
+    }
+
+    void UdpReactor::run()
+    {
+        printLog("Start UDP reactor");
+
+        struct epoll_event events[8];
+
+        while (true)
+        {
+            int n = epoll_wait(this->epoll_fd_, events, 8, -1);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0)
+                break;
+
+            bool woken = false;
+
+            for (int i = 0; i < n; i++)
+            {
+                if (events[i].data.ptr == nullptr)
+                {
+                    woken = true;
+                    continue;
+                }
+
+                this->drain(static_cast<Entry*>(events[i].data.ptr));
+            }
+
+            std::vector<std::unique_ptr<Entry>> deferred;
+
+            {
+                std::lock_guard<std::mutex> lock(this->mutex_);
+                deferred.swap(this->deferred_);
+
+                if (woken)
+                {
+                    uint64_t count;
+                    (void)!read(this->wake_fd_, &count, sizeof(count));
+
+                    // この回に取り出した通知は配送し終えたため、解除されたエントリは参照されない
+                    this->ack_seq_ = this->unlisten_seq_;
+                    this->ack_cv_.notify_all();
+                }
+
+                if (this->stop_)
+                    break;
+            }
+
+            for (auto& entry : deferred)
+                close(entry->fd);
+        }
+
+        // 停止時に待っている登録解除を戻す
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        this->ack_seq_ = this->unlisten_seq_;
+        this->ack_cv_.notify_all();
+
+        for (auto& entry : this->deferred_)
+            close(entry->fd);
+        this->deferred_.clear();
+    }
+
+    void UdpReactor::drain(Entry* entry)
+    {
+        static char buffers[BATCH_SIZE][PACKET_SIZE];
+        struct mmsghdr msgs[BATCH_SIZE];
+        struct iovec iovecs[BATCH_SIZE];
+        struct sockaddr_in addrs[BATCH_SIZE];
+
+        // ソケットが空になるまで（最大MAX_BATCHES回）まとめて受信する（配送中に自身が解除された場合はそこで止める）
+        for (int batch = 0; batch < MAX_BATCHES && entry->listener != nullptr; batch++)
+        {
+            for (int i = 0; i < BATCH_SIZE; i++)
+            {
+                iovecs[i].iov_base = buffers[i];
+                iovecs[i].iov_len  = PACKET_SIZE;
+
+                std::memset(&msgs[i].msg_hdr, 0, sizeof(msgs[i].msg_hdr));
+                msgs[i].msg_hdr.msg_iov     = &iovecs[i];
+                msgs[i].msg_hdr.msg_iovlen  = 1;
+                msgs[i].msg_hdr.msg_name    = &addrs[i];
+                msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+            }
+
+            int n = recvmmsg(entry->fd, msgs, BATCH_SIZE, MSG_DONTWAIT, nullptr);
+            if (n <= 0)
+                return;
+
+            for (int i = 0; i < n && entry->listener != nullptr; i++)
+            {
+                // バッファに収まらなかったパケットは途中で切れているため解析しない
+                if (msgs[i].msg_hdr.msg_flags & MSG_TRUNC)
+                {
+                    this->dropped_++;
+                    std::cerr << "[UDP ERROR]: Dropped truncated packet on port " << entry->port << std::endl;
+                    continue;
+                }
+
+                IpEndpointName remote(ntohl(addrs[i].sin_addr.s_addr), ntohs(addrs[i].sin_port));
+
+                try
+                {
+                    entry->listener->ProcessPacket(buffers[i], static_cast<int>(msgs[i].msg_len), remote);
+                }
+                catch (const std::exception& e)
+                {
+                    std::cerr << "[UDP ERROR]: " << e.what() << std::endl;
+                }
+            }
+
+            if (n < BATCH_SIZE)
+                return;
+        }
+    }
+
+    TuioReactorReceiver::TuioReactorReceiver(int port) noexcept
+        : port_(port)
+        , connected_(false)
+    {
+    }
+
+    TuioReactorReceiver::~TuioReactorReceiver()
+    {
+        this->disconnect();
+    }
+
+    void TuioReactorReceiver::connect(bool lock)
+    {
+        (void)lock;
+
+        if (this->connected_)
+            return;
+
+        this->connected_ = UdpReactor::get()->listen(this->port_, this);
+    }
+
+    void TuioReactorReceiver::disconnect()
+    {
+        if (!this->connected_)
+            return;
+
+        UdpReactor::get()->unlisten(this);
+        this->connected_ = false;
+    }
+
+}
@@ -7,10 +7,10 @@
 
 #include "Video.hpp"
 
-#include <thread>
+#include <algorithm>
 #include <chrono>
-#include <unistd.h>
-#include <iostream>
+#include <cstdint>
+#include <thread>
 
 #include "tllEngine.hpp"
 #include "Color.hpp"
@@ -30,43 +30,131 @@ namespace tll
         video_data_ = video;
     }
 
-    void Video::play(uint32_t pos_x, uint32_t pos_y, uint32_t size_rate)
+    Video::Video(std::unique_ptr<VideoFile> file)
+        : file_(std::move(file))
+    {
+    }
+
+    Video::~Video() = default;
+
+    Video::Video(Video&&) noexcept = default;
+    Video& Video::operator=(Video&&) noexcept = default;
+
+    bool Video::start(uint16_t width, uint16_t height, double max_fps)
+    {
+        if (this->decoder_ || this->file_)
+            return true;
+
+        if (!this->video_data_.isOpened())
+            return false;
+
+        if (width == 0 || height == 0)
+        {
+            width = static_cast<uint16_t>(this->video_data_.get(cv::CAP_PROP_FRAME_WIDTH));
+            height = static_cast<uint16_t>(this->video_data_.get(cv::CAP_PROP_FRAME_HEIGHT));
+        }
+
+        // 以降の読み出しはデコード用のスレッドだけが行う
+        this->decoder_ = std::make_unique<VideoDecoder>(this->video_data_, width, height, max_fps);
+        this->video_data_ = cv::VideoCapture();
+
+        return true;
+    }
+
+    bool Video::frameAt(double time)
     {
-        uint32_t width = static_cast<uint32_t>(video_data_.get(cv::CAP_PROP_FRAME_WIDTH));
-        uint32_t height = static_cast<uint32_t>(video_data_.get(cv::CAP_PROP_FRAME_HEIGHT));
+        if (this->file_)
+        {
+            // 変換済みの動画は再生位置のフレームを直接引く（シークも同じ手順で済む）
+            double index = std::max(time, 0.0) * this->file_->getFps();
+            this->file_finished_ = index >= this->file_->getFrameCount();
+            this->file_frame_ = this->file_->frame(static_cast<uint32_t>(std::min(index, static_cast<double>(UINT32_MAX))));
 
-        cv::Mat frame(cv::Size(width, height), CV_8UC3);  // Image object for a frame
+            return this->file_frame_.pixels != nullptr;
+        }
+
+        if (!this->start())
+            return false;
 
-        double end_frame = video_data_.get(cv::CAP_PROP_FRAME_COUNT);
+        double index = std::max(time, 0.0) * this->decoder_->getFps();
+        this->decoder_->acquire(static_cast<uint32_t>(std::min(index, static_cast<double>(UINT32_MAX))), this->current_);
 
-        cv::Mat dst = cv::Mat::ones(height / size_rate, width / size_rate, CV_8U);
+        return this->current_.valid;
+    }
 
-        for (uint32_t i = 0; i < static_cast<uint32_t>(end_frame); i++)
+    void Video::drawCurrent(int32_t x, int32_t y) const
+    {
+        if (this->file_)
         {
-            video_data_ >> frame;
+            if (this->file_frame_.pixels != nullptr)
+                TLL_ENGINE(PanelManager)->drawSurface(x, y, this->file_frame_);
+            return;
+        }
 
-            if (i % 5 != 0)
-                continue;
+        if (!this->current_.valid)
+            return;
 
-            cv::resize(frame, dst, dst.size());
+        // 送信はフレームの終わりにまとめて行う
+        TLL_ENGINE(PanelManager)->drawSurface(x, y, this->current_.surface);
+    }
+
+    bool Video::isFinished() const
+    {
+        if (this->file_)
+            return this->file_finished_;
+
+        return !this->decoder_ || this->decoder_->isFinished();
+    }
+
+    double Video::getFps() const
+    {
+        if (this->file_)
+            return this->file_->getFps();
+
+        if (this->decoder_)
+            return this->decoder_->getFps();
+
+        return this->video_data_.get(cv::CAP_PROP_FPS);
+    }
+
+    double Video::getDuration() const
+    {
+        double fps = this->getFps();
+        if (!(fps > 0.0))
+            return 0.0;
+
+        if (this->file_)
+            return this->file_->getFrameCount() / fps;
+
+        if (this->decoder_)
+            return this->decoder_->getFrameCount() / fps;
+
+        return this->video_data_.get(cv::CAP_PROP_FRAME_COUNT) / fps;
+    }
+
+    void Video::play(uint32_t pos_x, uint32_t pos_y, uint32_t size_rate)
+    {
+        size_rate = std::max<uint32_t>(size_rate, 1);
+
+        uint16_t width = static_cast<uint16_t>(video_data_.get(cv::CAP_PROP_FRAME_WIDTH) / size_rate);
+        uint16_t height = static_cast<uint16_t>(video_data_.get(cv::CAP_PROP_FRAME_HEIGHT) / size_rate);
+
+        if (!this->start(width, height))
+            return;
+
+        // 呼び出し元をブロックするため、描画と送信をここで行う
+        auto begin = std::chrono::steady_clock::now();
+
+        while (!this->isFinished())
+        {
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
 
-            for (int32_t y = 0; y < dst.rows; y++)
+            if (this->frameAt(elapsed.count()))
             {
-                for (int32_t x = 0; x < dst.cols; x++)
-                {
-                    TLL_ENGINE(PanelManager)->drawPixel(
-                        x + pos_x,
-                        y + pos_y,
-                        Color(
-                            dst.at<cv::Vec3b>(y, x)[2],
-                            dst.at<cv::Vec3b>(y, x)[1],
-                            dst.at<cv::Vec3b>(y, x)[0]
-                        )
-                    );
-                }
+                this->drawCurrent(static_cast<int32_t>(pos_x), static_cast<int32_t>(pos_y));
+                TLL_ENGINE(SerialManager)->sendColorData();
             }
 
-            TLL_ENGINE(SerialManager)->sendColorData();
             std::this_thread::sleep_for(std::chrono::milliseconds(16));
         }
 
@@ -0,0 +1,202 @@
+/**
+ * @file    VideoDecoder.cpp
+ * @brief   Background video decoder filling a bounded queue of panel-sized frames
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#include "VideoDecoder.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tll
+{
+
+    VideoDecoder::VideoDecoder(cv::VideoCapture capture, uint16_t width, uint16_t height, double max_fps, uint32_t capacity)
+        : capture_(capture)
+        , width_(width)
+        , height_(height)
+        , capacity_(std::max<uint32_t>(capacity, 1))
+        , wanted_(0)
+        , seek_to_(0)
+        , seek_(false)
+        , generation_(0)
+        , eof_(false)
+        , stop_(false)
+        , skipped_(0)
+    {
+        this->fps_ = this->capture_.get(cv::CAP_PROP_FPS);
+        if (!(this->fps_ > 0.0))
+            this->fps_ = 30.0;
+
+        this->frame_count_ = static_cast<uint32_t>(std::max(this->capture_.get(cv::CAP_PROP_FRAME_COUNT), 0.0));
+
+        // 例えば60fpsの動画を30fpsで再生する場合は1フレームおきにデコードする
+        this->step_ = max_fps > 0.0 ? static_cast<uint32_t>(std::max(std::ceil(this->fps_ / max_fps), 1.0)) : 1;
+
+        this->thread_ = std::thread(&VideoDecoder::threadDecode, this);
+    }
+
+    VideoDecoder::~VideoDecoder()
+    {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex_);
+            this->stop_ = true;
+        }
+        this->cv_.notify_all();
+
+        if (this->thread_.joinable())
+            this->thread_.join();
+    }
+
+    bool VideoDecoder::acquire(uint32_t index, VideoFrame& current)
+    {
+        bool changed = false;
+
+        {
+            std::lock_guard<std::mutex> lock(this->mutex_);
+
+            // 巻き戻された場合は溜めたフレームを捨て、その位置からデコードし直す
+            if (current.valid && index < current.index)
+            {
+                for (VideoFrame& frame : this->queue_)
+                    this->pool_.push_back(std::move(frame.surface));
+                this->queue_.clear();
+
+                this->seek_to_ = index - index % this->step_;
+                this->seek_ = true;
+                this->generation_++;
+
+                // 表示中のフレームは新しいフレームが届くまで残す
+                current.index = this->seek_to_;
+            }
+
+            while (!this->queue_.empty() && this->queue_.front().index <= index)
+            {
+                if (current.valid)
+                    this->pool_.push_back(std::move(current.surface));
+
+                current = std::move(this->queue_.front());
+                this->queue_.pop_front();
+                changed = true;
+            }
+
+            this->wanted_ = index;
+        }
+
+        this->cv_.notify_one();
+
+        return changed;
+    }
+
+    bool VideoDecoder::isFinished()
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        return this->eof_ && !this->seek_ && this->queue_.empty();
+    }
+
+    uint64_t VideoDecoder::getSkippedFrames()
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        return this->skipped_;
+    }
+
+    void VideoDecoder::threadDecode()
+    {
+        uint32_t next = 0;    // 次に読み出すフレーム番号
+        cv::Mat frame;
+
+        while (true)
+        {
+            uint32_t target;
+            uint32_t generation;
+            Surface surface;
+
+            {
+                std::unique_lock<std::mutex> lock(this->mutex_);
+                this->cv_.wait(lock, [this]()
+                {
+                    return this->stop_ || this->seek_ || (!this->eof_ && this->queue_.size() < this->capacity_);
+                });
+
+                if (this->stop_)
+                    return;
+
+                if (this->seek_)
+                {
+                    this->seek_ = false;
+                    this->eof_ = false;
+                    next = this->seek_to_;
+
+                    lock.unlock();
+                    this->capture_.set(cv::CAP_PROP_POS_FRAMES, next);
+                    continue;
+                }
+
+                // 再生位置より前のフレームは表示されないため、間隔に揃えた再生位置以降からデコードする
+                target = std::max(next, this->wanted_);
+                target += (this->step_ - target % this->step_) % this->step_;
+
+                generation = this->generation_;
+
+                if (!this->pool_.empty())
+                {
+                    surface = std::move(this->pool_.back());
+                    this->pool_.pop_back();
+                }
+            }
+
+            // 読み飛ばすフレームはgrab()だけで済ませ、デコードしない
+            bool ok = true;
+            uint64_t skipped = 0;
+            for (; next < target && ok; next++, skipped++)
+                ok = this->capture_.grab();
+
+            ok = ok && this->capture_.read(frame) && !frame.empty();
+            uint32_t index = next++;
+
+            if (ok)
+                this->convert(frame, surface);
+
+            std::lock_guard<std::mutex> lock(this->mutex_);
+
+            this->skipped_ += skipped;
+
+            if (!ok)
+                this->eof_ = true;
+
+            // デコード中に巻き戻された場合は捨てる
+            if (!ok || generation != this->generation_)
+            {
+                this->pool_.push_back(std::move(surface));
+                continue;
+            }
+
+            VideoFrame decoded;
+            decoded.index = index;
+            decoded.valid = true;
+            decoded.surface = std::move(surface);
+            this->queue_.push_back(std::move(decoded));
+        }
+    }
+
+    void VideoDecoder::convert(const cv::Mat& frame, Surface& surface)
+    {
+        cv::resize(frame, this->scaled_, cv::Size(this->width_, this->height_), 0, 0, cv::INTER_AREA);
+
+        if (surface.width != this->width_ || surface.height != this->height_)
+            surface.resize(this->width_, this->height_);
+
+        // OpenCVのBGRからパネルのRGBに並べ替える
+        for (int y = 0; y < this->scaled_.rows; y++)
+        {
+            const cv::Vec3b* src = this->scaled_.ptr<cv::Vec3b>(y);
+            Color* dst = &surface.pixels[y * surface.width];
+
+            for (int x = 0; x < this->scaled_.cols; x++)
+                dst[x] = Color(src[x][2], src[x][1], src[x][0]);
+        }
+    }
+
+}
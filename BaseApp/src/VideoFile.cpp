@@ -0,0 +1,221 @@
+/**
+ * @file    VideoFile.cpp
+ * @brief   Memory-mapped panel-resolution video (.tllvid)
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#include "VideoFile.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace tll
+{
+
+    VideoFile::VideoFile() noexcept
+        : data_(nullptr)
+        , size_(0)
+        , header_(nullptr)
+        , frames_(nullptr)
+        , buffer_index_(UINT32_MAX)
+    {
+    }
+
+    VideoFile::~VideoFile()
+    {
+        this->close();
+    }
+
+    bool VideoFile::open(const std::string& path)
+    {
+        this->close();
+
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            std::cerr << "[ERROR] Failed to open video file " << path << std::endl;
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(vid::Header))
+        {
+            std::cerr << "[ERROR] Invalid video file " << path << std::endl;
+            ::close(fd);
+            return false;
+        }
+
+        void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+
+        if (data == MAP_FAILED)
+        {
+            std::cerr << "[ERROR] Failed to map video file " << path << std::endl;
+            return false;
+        }
+
+        this->data_ = static_cast<const uint8_t*>(data);
+        this->size_ = static_cast<size_t>(st.st_size);
+        this->header_ = reinterpret_cast<const vid::Header*>(this->data_);
+
+        const vid::Header& header = *this->header_;
+        uint64_t index_bytes = static_cast<uint64_t>(header.frame_count) * sizeof(vid::FrameEntry);
+
+        bool valid = std::memcmp(header.magic, vid::MAGIC, sizeof(vid::MAGIC)) == 0 && header.version == vid::VERSION
+            && header.width > 0 && header.height > 0 && header.frame_count > 0 && header.fps_num > 0 && header.fps_den > 0
+            && header.index_offset % alignof(vid::FrameEntry) == 0
+            && header.index_offset <= this->size_ && index_bytes <= this->size_ - header.index_offset;
+
+        if (valid)
+        {
+            this->frames_ = reinterpret_cast<const vid::FrameEntry*>(this->data_ + header.index_offset);
+
+            uint64_t raw_size = static_cast<uint64_t>(header.width) * header.height * sizeof(Color);
+
+            // 再生中に検査しなくて済むよう、フレームの表をここで確かめる（データの中身は復元時に確かめる）
+            for (uint32_t i = 0; i < header.frame_count && valid; i++)
+            {
+                const vid::FrameEntry& entry = this->frames_[i];
+
+                valid = entry.offset <= this->size_ && entry.size <= this->size_ - entry.offset
+                    && entry.key <= i && this->frames_[entry.key].type != vid::EFrame::DELTA
+                    && (entry.type != vid::EFrame::RAW || entry.size == raw_size)
+                    && (entry.type == vid::EFrame::RAW || entry.type == vid::EFrame::RLE || entry.type == vid::EFrame::DELTA);
+            }
+        }
+
+        if (!valid)
+        {
+            std::cerr << "[ERROR] Invalid video file " << path << std::endl;
+            this->close();
+            return false;
+        }
+
+        this->buffer_.resize(header.width, header.height);
+        this->buffer_index_ = UINT32_MAX;
+
+        return true;
+    }
+
+    void VideoFile::close() noexcept
+    {
+        if (this->data_ != nullptr)
+            munmap(const_cast<uint8_t*>(this->data_), this->size_);
+
+        this->data_ = nullptr;
+        this->size_ = 0;
+        this->header_ = nullptr;
+        this->frames_ = nullptr;
+        this->buffer_index_ = UINT32_MAX;
+    }
+
+    SurfaceView VideoFile::frame(uint32_t index)
+    {
+        if (this->header_ == nullptr)
+            return SurfaceView{ 0, 0, nullptr };
+
+        index = std::min(index, this->header_->frame_count - 1);
+        const vid::FrameEntry& entry = this->frames_[index];
+
+        // 無圧縮のフレームは復元せずにマップした領域から直接描画する
+        if (entry.type == vid::EFrame::RAW)
+            return SurfaceView{ this->header_->width, this->header_->height, reinterpret_cast<const Color*>(this->data_ + entry.offset) };
+
+        if (this->buffer_index_ != index)
+        {
+            // 順に再生している場合は直前のフレームに差分を適用し、シークした場合はキーフレームから復元し直す
+            uint32_t from = entry.key;
+            if (entry.type == vid::EFrame::DELTA && this->buffer_index_ != UINT32_MAX
+                && this->buffer_index_ >= entry.key && this->buffer_index_ < index)
+                from = this->buffer_index_ + 1;
+            else if (entry.type == vid::EFrame::RLE)
+                from = index;
+
+            this->buffer_index_ = UINT32_MAX;
+
+            for (uint32_t i = from; i <= index; i++)
+            {
+                if (!this->decode(i))
+                    return SurfaceView{ 0, 0, nullptr };
+            }
+
+            this->buffer_index_ = index;
+        }
+
+        return this->buffer_;
+    }
+
+    double VideoFile::getFps() const noexcept
+    {
+        if (this->header_ == nullptr)
+            return 0.0;
+
+        return static_cast<double>(this->header_->fps_num) / this->header_->fps_den;
+    }
+
+    bool VideoFile::decode(uint32_t index)
+    {
+        const vid::FrameEntry& entry = this->frames_[index];
+        const uint8_t* src = this->data_ + entry.offset;
+        const uint8_t* end = src + entry.size;
+
+        Color* dst = this->buffer_.pixels.data();
+        size_t count = this->buffer_.pixels.size();
+        size_t pos = 0;
+
+        switch (entry.type)
+        {
+        case vid::EFrame::RAW:
+            std::memcpy(dst, src, count * sizeof(Color));
+            return true;
+
+        case vid::EFrame::RLE:
+            while (pos < count)
+            {
+                if (end - src < static_cast<ptrdiff_t>(1 + sizeof(Color)))
+                    return false;
+
+                size_t run = std::min<size_t>(src[0] + 1, count - pos);
+                Color color;
+                std::memcpy(&color, src + 1, sizeof(Color));
+                src += 1 + sizeof(Color);
+
+                std::fill_n(dst + pos, run, color);
+                pos += run;
+            }
+            return true;
+
+        case vid::EFrame::DELTA:
+            while (src < end && pos < count)
+            {
+                size_t length = (src[0] & ~vid::LITERAL) + 1;
+                size_t run = std::min(length, count - pos);
+
+                if ((src[0] & vid::LITERAL) != 0)
+                {
+                    if (static_cast<size_t>(end - src - 1) < length * sizeof(Color))
+                        return false;
+
+                    std::memcpy(dst + pos, src + 1, run * sizeof(Color));
+                    src += 1 + length * sizeof(Color);
+                }
+                else
+                    src++;
+
+                pos += run;
+            }
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+}
@@ -7,8 +7,11 @@
 
 #include <cstddef>
 
+#include "AssetManager.hpp"
+#include "CommandBus.hpp"
 #include "Common.hpp"
 #include "Event.hpp"
+#include "LatencyTracer.hpp"
 #include "PanelManager.hpp"
 #include "SerialManager.hpp"
 #include "TextRenderer.hpp"
@@ -0,0 +1,168 @@
+/**
+ * @file    ImageBench.cpp
+ * @brief   Benchmark of tll::Image drawing against the per-pixel path
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <opencv2/opencv.hpp>
+
+#include "Image.hpp"
+#include "PanelManager.hpp"
+#include "SerialManager.hpp"
+#include "tllEngine.hpp"
+
+namespace
+{
+    tll::IPanelManager* panel()
+    {
+        return tll::tllEngine::get()->getComponent<tll::IPanelManager>();
+    }
+
+    /* 従来のImage::draw（ピクセルごとにat<>と仮想関数を呼び、描画のたびに送信を要求する） */
+    void drawLegacy(const cv::Mat& img, uint32_t x, uint32_t y)
+    {
+        for (int Y = 0; Y < img.rows; Y++)
+        {
+            for (int X = 0; X < img.cols; X++)
+            {
+                panel()->drawPixel(
+                    x + X,
+                    y + Y,
+                    tll::Color(
+                        img.at<cv::Vec3b>(Y, X)[2],
+                        img.at<cv::Vec3b>(Y, X)[1],
+                        img.at<cv::Vec3b>(Y, X)[0]
+                    )
+                );
+            }
+        }
+
+        tll::tllEngine::get()->getComponent<tll::ISerialManager>()->sendColorData();
+    }
+
+    void drawLegacy(const cv::Mat& img, uint32_t x, uint32_t y, tll::Color color)
+    {
+        for (int Y = 0; Y < img.rows; Y++)
+        {
+            for (int X = 0; X < img.cols; X++)
+            {
+                if (img.at<cv::Vec3b>(Y, X)[2] == 0 &&
+                    img.at<cv::Vec3b>(Y, X)[1] == 0 &&
+                    img.at<cv::Vec3b>(Y, X)[0] == 0)
+                {
+                    panel()->drawPixel(x + X, y + Y, tll::Color(0, 0, 0));
+                }
+                else
+                {
+                    panel()->drawPixel(x + X, y + Y, tll::Color(color.r_, color.g_, color.b_));
+                }
+            }
+        }
+
+        tll::tllEngine::get()->getComponent<tll::ISerialManager>()->sendColorData();
+    }
+
+    // 市松模様とグラデーションを混ぜた合成画像（黒のピクセルを含む）
+    cv::Mat makeImage(int width, int height)
+    {
+        cv::Mat img(height, width, CV_8UC3);
+
+        for (int Y = 0; Y < height; Y++)
+        {
+            cv::Vec3b* row = img.ptr<cv::Vec3b>(Y);
+            for (int X = 0; X < width; X++)
+            {
+                bool lit = ((X / 3) + (Y / 3)) % 2 == 0;
+                row[X][0] = lit ? static_cast<uint8_t>(X * 4) : 0;
+                row[X][1] = lit ? static_cast<uint8_t>(Y * 8) : 0;
+                row[X][2] = lit ? 255 : 0;
+            }
+        }
+
+        return img;
+    }
+
+    // 1回あたりの描画時間[ns]
+    double measure(uint32_t iterations, const std::function<void()>& draw)
+    {
+        for (uint32_t i = 0; i < iterations / 10; i++)
+            draw();
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < iterations; i++)
+            draw();
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+        return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    }
+
+    /* 計測する描画条件 */
+    struct Case
+    {
+        const char* name;
+        int width;
+        int height;
+        uint32_t x;
+        uint32_t y;
+    };
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t iterations = 20000;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc)
+            iterations = std::max(std::atoi(argv[++i]), 1);
+        else
+        {
+            std::cout << "Usage: " << argv[0] << " [--iterations N]" << std::endl;
+            return 1;
+        }
+    }
+
+    panel()->init(64, 32);
+
+    const Case cases[] = {
+        { "icon 15x15",      15, 15,  3,  8 },
+        { "full 64x32",      64, 32,  0,  0 },
+        { "clipped 64x32",   64, 32, 40, 20 },
+    };
+
+    const tll::Color tint(0, 128, 255);
+
+    std::cout << std::left << std::setw(16) << "case" << std::setw(8) << "mode"
+              << std::right << std::setw(14) << "legacy[ns]" << std::setw(14) << "blit[ns]" << std::setw(10) << "speedup" << std::endl;
+
+    for (const Case& c : cases)
+    {
+        cv::Mat mat = makeImage(c.width, c.height);
+        tll::Image image(mat);
+
+        double legacy = measure(iterations, [&]() { drawLegacy(mat, c.x, c.y); });
+        double blit   = measure(iterations, [&]() { image.draw(c.x, c.y); });
+
+        double legacy_tint = measure(iterations, [&]() { drawLegacy(mat, c.x, c.y, tint); });
+        double blit_tint   = measure(iterations, [&]() { image.draw(c.x, c.y, tint); });
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << std::left << std::setw(16) << c.name << std::setw(8) << "plain"
+                  << std::right << std::setw(14) << legacy << std::setw(14) << blit << std::setw(9) << (legacy / blit) << "x" << std::endl
+                  << std::left << std::setw(16) << c.name << std::setw(8) << "tinted"
+                  << std::right << std::setw(14) << legacy_tint << std::setw(14) << blit_tint << std::setw(9) << (legacy_tint / blit_tint) << "x" << std::endl;
+    }
+
+    return 0;
+}
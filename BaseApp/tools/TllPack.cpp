@@ -0,0 +1,349 @@
+/**
+ * @file    TllPack.cpp
+ * @brief   Offline packer of images and fonts into a memory-mappable .tllpak file
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <opencv2/freetype.hpp>
+#include <opencv2/opencv.hpp>
+
+#include "AssetPack.hpp"
+#include "PanelManager.hpp"
+
+namespace
+{
+    namespace pak = tll::pak;
+
+    /* 8バイト境界に揃えながらデータを書き出す */
+    class PackWriter
+    {
+    public:
+        explicit PackWriter(const std::string& path)
+            : out_(path, std::ios::binary | std::ios::trunc)
+            , offset_(0)
+        {
+            // ヘッダは最後に書き直す
+            pak::Header header{};
+            this->write(&header, sizeof(header));
+        }
+
+        bool good() const { return this->out_.good(); }
+
+        // 境界に揃えてから書き出し、書き出した位置を返す
+        uint64_t write(const void* data, uint64_t bytes)
+        {
+            static const char zero[pak::ALIGN] = {};
+
+            uint64_t aligned = pak::align(this->offset_);
+            this->out_.write(zero, aligned - this->offset_);
+            this->out_.write(static_cast<const char*>(data), bytes);
+            this->offset_ = aligned + bytes;
+
+            return aligned;
+        }
+
+        bool addEntry(const std::string& name, pak::Entry entry)
+        {
+            if (name.size() >= pak::NAME_SIZE)
+            {
+                std::cerr << "[ERROR] Name is too long: " << name << std::endl;
+                return false;
+            }
+
+            if (!this->names_.insert(name).second)
+            {
+                std::cerr << "[ERROR] Duplicate name: " << name << std::endl;
+                return false;
+            }
+
+            std::memset(entry.name, 0, sizeof(entry.name));
+            std::memcpy(entry.name, name.c_str(), name.size());
+            this->entries_.push_back(entry);
+
+            return true;
+        }
+
+        // 目次とヘッダを書き出す
+        bool finish()
+        {
+            pak::Header header{};
+            std::memcpy(header.magic, pak::MAGIC, sizeof(pak::MAGIC));
+            header.version = pak::VERSION;
+            header.entry_count = static_cast<uint32_t>(this->entries_.size());
+            header.index_offset = this->write(this->entries_.data(), this->entries_.size() * sizeof(pak::Entry));
+
+            this->out_.seekp(0);
+            this->out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            this->out_.close();
+
+            return !this->out_.fail();
+        }
+
+        size_t entryCount() const { return this->entries_.size(); }
+        uint64_t size() const { return this->offset_; }
+
+    private:
+        std::ofstream out_;
+        uint64_t offset_;
+
+        std::vector<pak::Entry> entries_;
+        std::set<std::string> names_;
+    };
+
+    std::string encodeUtf8(uint32_t codepoint)
+    {
+        std::string str;
+
+        if (codepoint < 0x80)
+            str += static_cast<char>(codepoint);
+        else if (codepoint < 0x800)
+        {
+            str += static_cast<char>(0xC0 | (codepoint >> 6));
+            str += static_cast<char>(0x80 | (codepoint & 0x3F));
+        }
+        else if (codepoint < 0x10000)
+        {
+            str += static_cast<char>(0xE0 | (codepoint >> 12));
+            str += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+            str += static_cast<char>(0x80 | (codepoint & 0x3F));
+        }
+        else
+        {
+            str += static_cast<char>(0xF0 | (codepoint >> 18));
+            str += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+            str += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+            str += static_cast<char>(0x80 | (codepoint & 0x3F));
+        }
+
+        return str;
+    }
+
+    // 画像を読み込み、パネルと同じ形式の画素とマスクを書き出す
+    bool packImage(PackWriter& writer, const std::string& path, uint16_t width, uint16_t height)
+    {
+        cv::Mat img = cv::imread(path);
+        if (img.empty())
+        {
+            std::cerr << "[ERROR] Failed to load " << path << std::endl;
+            return false;
+        }
+
+        if (width != 0 && height != 0)
+            cv::resize(img, img, cv::Size(width, height), 0, 0, cv::INTER_AREA);
+
+        // BGRからRGBへ並べ替える
+        tll::Surface surface;
+        surface.resize(static_cast<uint16_t>(img.cols), static_cast<uint16_t>(img.rows));
+
+        for (int y = 0; y < img.rows; y++)
+        {
+            const cv::Vec3b* src = img.ptr<cv::Vec3b>(y);
+            tll::Color* dst = &surface.pixels[y * surface.width];
+
+            for (int x = 0; x < img.cols; x++)
+                dst[x] = tll::Color(src[x][2], src[x][1], src[x][0]);
+        }
+
+        tll::Mask mask;
+        mask.build(surface);
+
+        pak::Entry entry{};
+        entry.type = pak::EEntry::IMAGE;
+        entry.width = surface.width;
+        entry.height = surface.height;
+        entry.words = mask.words;
+        entry.data_offset = writer.write(surface.pixels.data(), surface.pixels.size() * sizeof(tll::Color));
+        entry.mask_offset = writer.write(mask.bits.data(), mask.bits.size() * sizeof(uint64_t));
+
+        std::string name = std::filesystem::path(path).stem().string();
+        if (!writer.addEntry(name, entry))
+            return false;
+
+        std::cout << "image  " << name << " (" << entry.width << "x" << entry.height << ")" << std::endl;
+        return true;
+    }
+
+    // フォントを指定サイズでラスタライズし、文字ごとのマスクを書き出す
+    bool packFont(PackWriter& writer, const std::string& path, int32_t size, const std::set<uint32_t>& codepoints)
+    {
+        if (!std::filesystem::exists(path))
+        {
+            std::cerr << "[ERROR] Failed to load " << path << std::endl;
+            return false;
+        }
+
+        cv::Ptr<cv::freetype::FreeType2> ft2 = cv::freetype::createFreeType2();
+        ft2->loadFontData(path.c_str(), 0);
+
+        // 行の高さは英字の上端から下端まで
+        int32_t baseline = 0;
+        cv::Size line = ft2->getTextSize("Hg", size, -1, &baseline);
+        uint16_t line_height = static_cast<uint16_t>(line.height + baseline);
+
+        std::vector<pak::Glyph> glyphs;
+
+        for (uint32_t codepoint : codepoints)
+        {
+            std::string text = encodeUtf8(codepoint);
+
+            int32_t glyph_baseline = 0;
+            cv::Size glyph_size = ft2->getTextSize(text, size, -1, &glyph_baseline);
+
+            pak::Glyph glyph{};
+            glyph.codepoint = codepoint;
+            glyph.width = static_cast<uint16_t>(std::max(glyph_size.width, 0));
+            glyph.height = glyph.width > 0 ? line_height : 0;
+            glyph.words = static_cast<uint16_t>((glyph.width + 63) / 64);
+
+            // 空白は描画する画素を持たないため、幅だけを持たせる
+            glyph.advance = glyph.width > 0 ? glyph.width : static_cast<uint16_t>(size / 3 + 1);
+
+            std::vector<uint64_t> bits(glyph.words * glyph.height, 0);
+
+            if (glyph.width > 0)
+            {
+                cv::Mat canvas = cv::Mat::zeros(glyph.height, glyph.width, CV_8UC3);
+                ft2->putText(canvas, text, cv::Point(0, line.height), size, cv::Scalar::all(255), -1, cv::LINE_8, true);
+
+                for (int y = 0; y < canvas.rows; y++)
+                {
+                    const cv::Vec3b* src = canvas.ptr<cv::Vec3b>(y);
+                    uint64_t* row = &bits[y * glyph.words];
+
+                    for (int x = 0; x < canvas.cols; x++)
+                    {
+                        if (src[x][0] >= 128)
+                            row[x >> 6] |= uint64_t(1) << (x & 63);
+                    }
+                }
+            }
+
+            glyph.mask_offset = writer.write(bits.data(), bits.size() * sizeof(uint64_t));
+            glyphs.push_back(glyph);
+        }
+
+        pak::Entry entry{};
+        entry.type = pak::EEntry::FONT;
+        entry.count = static_cast<uint32_t>(glyphs.size());
+        entry.height = line_height;
+        entry.data_offset = writer.write(glyphs.data(), glyphs.size() * sizeof(pak::Glyph));
+
+        std::string name = std::filesystem::path(path).stem().string() + "@" + std::to_string(size);
+        if (!writer.addEntry(name, entry))
+            return false;
+
+        std::cout << "font   " << name << " (" << glyphs.size() << " glyphs, line height " << line_height << ")" << std::endl;
+        return true;
+    }
+
+    void usage(const char* argv0)
+    {
+        std::cout << "Usage: " << argv0 << " -o OUT.tllpak [--size WxH] IMAGE... [--chars TEXT] [--font FILE:SIZE]..." << std::endl
+                  << "  --size WxH        Scale following images to WxH (0x0 keeps the original size)" << std::endl
+                  << "  --chars TEXT      Rasterize these characters in addition to printable ASCII" << std::endl
+                  << "  --font FILE:SIZE  Rasterize FILE at SIZE pixels (named <file stem>@<size>)" << std::endl
+                  << "Images are named by their file stem." << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string out_path;
+    uint16_t width = 0;
+    uint16_t height = 0;
+
+    // 既定では表示可能なASCII文字をラスタライズする
+    std::set<uint32_t> codepoints;
+    for (uint32_t c = 0x20; c < 0x7F; c++)
+        codepoints.insert(c);
+
+    // 出力先を先に決めるため、引数を2回走査する
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            out_path = argv[++i];
+    }
+
+    if (out_path.empty())
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    PackWriter writer(out_path);
+    if (!writer.good())
+    {
+        std::cerr << "[ERROR] Failed to create " << out_path << std::endl;
+        return 1;
+    }
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool ok = true;
+
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            i++;
+        else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+        {
+            unsigned w = 0, h = 0;
+            ok = sscanf(argv[++i], "%ux%u", &w, &h) == 2 && w <= UINT16_MAX && h <= UINT16_MAX;
+            width = static_cast<uint16_t>(w);
+            height = static_cast<uint16_t>(h);
+        }
+        else if (strcmp(argv[i], "--chars") == 0 && i + 1 < argc)
+        {
+            std::string text = argv[++i];
+
+            size_t pos = 0;
+            while (pos < text.size())
+            {
+                uint32_t codepoint;
+                if (pak::decodeUtf8(text, pos, codepoint))
+                    codepoints.insert(codepoint);
+            }
+        }
+        else if (strcmp(argv[i], "--font") == 0 && i + 1 < argc)
+        {
+            std::string spec = argv[++i];
+            size_t colon = spec.rfind(':');
+            int32_t size = colon == std::string::npos ? 0 : std::atoi(spec.c_str() + colon + 1);
+
+            ok = size > 0 && packFont(writer, spec.substr(0, colon), size, codepoints);
+        }
+        else if (argv[i][0] == '-')
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        else
+            ok = packImage(writer, argv[i], width, height);
+
+        if (!ok)
+        {
+            std::cerr << "[ERROR] Failed at argument: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    if (!writer.finish())
+    {
+        std::cerr << "[ERROR] Failed to write " << out_path << std::endl;
+        return 1;
+    }
+
+    std::cout << "Wrote " << writer.entryCount() << " entries (" << writer.size() << " bytes) to " << out_path << std::endl;
+
+    return 0;
+}
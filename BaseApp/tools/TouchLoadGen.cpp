@@ -0,0 +1,274 @@
+/**
+ * @file    TouchLoadGen.cpp
+ * @brief   Synthetic touch OSC generator, recorder and replayer
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ip/IpEndpointName.h"
+#include "ip/PacketListener.h"
+#include "ip/UdpSocket.h"
+#include "osc/OscOutboundPacketStream.h"
+
+namespace
+{
+    // 記録ファイルの先頭に置く識別子
+    const char REC_MAGIC[8] = { 'T', 'L', 'L', 'R', 'E', 'C', '1', '\0' };
+
+    struct Options
+    {
+        std::string host = "127.0.0.1";
+        int port = 9000;
+        int forward_port = 0;
+
+        uint32_t fingers = 5;
+        uint32_t rate = 60;          // 指1本あたりの更新頻度[Hz]
+        uint32_t duration = 10;      // 生成時間[s]
+        bool blobs = false;
+
+        uint16_t width = 64;
+        uint16_t height = 32;
+
+        std::string file;
+    };
+
+    void printUsage(const char* name)
+    {
+        std::cout << "Usage:" << std::endl;
+        std::cout << "  " << name << " gen    [--host H] [--port P] [--fingers N] [--rate HZ] [--duration SEC] [--blobs]" << std::endl;
+        std::cout << "  " << name << " record FILE [--port P] [--forward-port P]" << std::endl;
+        std::cout << "  " << name << " replay FILE [--host H] [--port P]" << std::endl;
+    }
+
+    /* 合成タッチイベントを一定頻度で送信する */
+    int generate(const Options& opt)
+    {
+        UdpTransmitSocket sock(IpEndpointName(opt.host.c_str(), opt.port));
+
+        char buff[256];
+        uint64_t sent = 0;
+
+        auto send = [&](osc::OutboundPacketStream& p)
+        {
+            sock.Send(p.Data(), p.Size());
+            sent++;
+        };
+
+        const auto interval = std::chrono::nanoseconds(1000000000LL / opt.rate);
+        const auto start = std::chrono::steady_clock::now();
+        const auto end = start + std::chrono::seconds(opt.duration);
+
+        auto next = start;
+        uint64_t tick = 0;
+
+        while (next < end)
+        {
+            // 各指はパネル中心の周りを異なる位相で周回する
+            for (uint32_t i = 0; i < opt.fingers; i++)
+            {
+                double phase = (tick * 0.05) + (2.0 * M_PI * i / opt.fingers);
+                int32_t x = static_cast<int32_t>(opt.width  / 2 + std::cos(phase) * (opt.width  / 2 - 2));
+                int32_t y = static_cast<int32_t>(opt.height / 2 + std::sin(phase) * (opt.height / 2 - 2));
+
+                std::string touch = "/touch/" + std::to_string(i + 1) + "/point";
+                osc::OutboundPacketStream p(buff, sizeof(buff));
+                p << osc::BeginMessage(touch.c_str()) << x << y << osc::EndMessage;
+                send(p);
+
+                if (opt.blobs)
+                {
+                    std::string blob = "/blob/" + std::to_string(i + 1) + "/bbox1";
+                    osc::OutboundPacketStream pb(buff, sizeof(buff));
+                    pb << osc::BeginMessage(blob.c_str()) << x - 1 << y - 1 << 3 << 3 << osc::EndMessage;
+                    send(pb);
+                }
+            }
+
+            tick++;
+            next += interval;
+            std::this_thread::sleep_until(next);
+        }
+
+        for (uint32_t i = 0; i < opt.fingers; i++)
+        {
+            std::string touch = "/touch/" + std::to_string(i + 1) + "/delete";
+            osc::OutboundPacketStream p(buff, sizeof(buff));
+            p << osc::BeginMessage(touch.c_str()) << osc::EndMessage;
+            send(p);
+
+            if (opt.blobs)
+            {
+                std::string blob = "/blob/" + std::to_string(i + 1) + "/delete";
+                osc::OutboundPacketStream pb(buff, sizeof(buff));
+                pb << osc::BeginMessage(blob.c_str()) << osc::EndMessage;
+                send(pb);
+            }
+        }
+
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Sent " << sent << " messages in " << elapsed << "s (" << (sent / elapsed) << " msg/s)" << std::endl;
+
+        return 0;
+    }
+
+    /* 受信したパケットを受信時刻とともにファイルへ書き出す */
+    class Recorder : public PacketListener
+    {
+    public:
+        Recorder(std::ofstream& ofs, UdpTransmitSocket* forward)
+            : ofs_(ofs)
+            , forward_(forward)
+            , start_(std::chrono::steady_clock::now())
+            , count_(0)
+        {
+        }
+
+        void ProcessPacket(const char* data, int size, const IpEndpointName& remote_end_pt) override
+        {
+            (void)remote_end_pt;
+
+            uint64_t t = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - this->start_).count();
+            uint32_t n = static_cast<uint32_t>(size);
+
+            this->ofs_.write(reinterpret_cast<const char*>(&t), sizeof(t));
+            this->ofs_.write(reinterpret_cast<const char*>(&n), sizeof(n));
+            this->ofs_.write(data, size);
+
+            if (this->forward_)
+                this->forward_->Send(data, size);
+
+            this->count_++;
+        }
+
+        uint64_t getCount() const { return this->count_; }
+
+    private:
+        std::ofstream& ofs_;
+        UdpTransmitSocket* forward_;
+
+        std::chrono::steady_clock::time_point start_;
+        uint64_t count_;
+    };
+
+    int record(const Options& opt)
+    {
+        std::ofstream ofs(opt.file, std::ios::binary);
+        if (!ofs)
+        {
+            std::cerr << "[ERROR] Failed to open " << opt.file << std::endl;
+            return 1;
+        }
+        ofs.write(REC_MAGIC, sizeof(REC_MAGIC));
+
+        // 記録しながらTLL本体にも転送する場合
+        UdpTransmitSocket* forward = nullptr;
+        if (opt.forward_port > 0)
+            forward = new UdpTransmitSocket(IpEndpointName("127.0.0.1", opt.forward_port));
+
+        Recorder recorder(ofs, forward);
+        UdpListeningReceiveSocket sock(IpEndpointName(IpEndpointName::ANY_ADDRESS, opt.port), &recorder);
+
+        std::cout << "Recording port " << opt.port << " to " << opt.file << " (Ctrl-C to stop)" << std::endl;
+        sock.RunUntilSigInt();
+
+        std::cout << "Recorded " << recorder.getCount() << " packets" << std::endl;
+
+        delete forward;
+        return 0;
+    }
+
+    /* 記録したパケットを記録時と同じ間隔で送信する */
+    int replay(const Options& opt)
+    {
+        std::ifstream ifs(opt.file, std::ios::binary);
+
+        char magic[sizeof(REC_MAGIC)];
+        if (!ifs || !ifs.read(magic, sizeof(magic)) || std::memcmp(magic, REC_MAGIC, sizeof(REC_MAGIC)) != 0)
+        {
+            std::cerr << "[ERROR] " << opt.file << " is not a touch recording" << std::endl;
+            return 1;
+        }
+
+        UdpTransmitSocket sock(IpEndpointName(opt.host.c_str(), opt.port));
+
+        std::vector<char> data;
+        uint64_t t;
+        uint32_t n;
+        uint64_t sent = 0;
+
+        const auto start = std::chrono::steady_clock::now();
+
+        while (ifs.read(reinterpret_cast<char*>(&t), sizeof(t)) && ifs.read(reinterpret_cast<char*>(&n), sizeof(n)))
+        {
+            data.resize(n);
+            if (!ifs.read(data.data(), n))
+                break;
+
+            std::this_thread::sleep_until(start + std::chrono::microseconds(t));
+            sock.Send(data.data(), n);
+            sent++;
+        }
+
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Replayed " << sent << " packets in " << elapsed << "s" << std::endl;
+
+        return 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::string mode = argv[1];
+    Options opt;
+
+    // 記録時の既定の待受ポートはTLL本体と重ならないようにする
+    if (mode == "record")
+        opt.port = 9001;
+
+    int i = 2;
+    if ((mode == "record" || mode == "replay") && i < argc)
+        opt.file = argv[i++];
+
+    for (; i < argc; i++)
+    {
+        if      (strcmp(argv[i], "--host") == 0 && i + 1 < argc)         opt.host = argv[++i];
+        else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc)         opt.port = std::atoi(argv[++i]);
+        else if (strcmp(argv[i], "--forward-port") == 0 && i + 1 < argc) opt.forward_port = std::atoi(argv[++i]);
+        else if (strcmp(argv[i], "--fingers") == 0 && i + 1 < argc)      opt.fingers = std::atoi(argv[++i]);
+        else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc)         opt.rate = std::atoi(argv[++i]);
+        else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc)     opt.duration = std::atoi(argv[++i]);
+        else if (strcmp(argv[i], "--blobs") == 0)                        opt.blobs = true;
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (mode == "gen" && opt.rate > 0)
+        return generate(opt);
+    if (mode == "record" && !opt.file.empty())
+        return record(opt);
+    if (mode == "replay" && !opt.file.empty())
+        return replay(opt);
+
+    printUsage(argv[0]);
+    return 1;
+}
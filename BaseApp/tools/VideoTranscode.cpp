@@ -0,0 +1,317 @@
+/**
+ * @file    VideoTranscode.cpp
+ * @brief   Offline transcoder of videos into panel-resolution .tllvid files
+ * @author  Yoshito Nakaue
+ * @date    2026/10/19
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "PanelManager.hpp"
+#include "VideoFile.hpp"
+
+namespace
+{
+    namespace vid = tll::vid;
+
+    bool same(const tll::Color& a, const tll::Color& b)
+    {
+        return a.r_ == b.r_ && a.g_ == b.g_ && a.b_ == b.b_;
+    }
+
+    void append(std::vector<uint8_t>& out, const tll::Color* pixels, size_t count)
+    {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(pixels);
+        out.insert(out.end(), bytes, bytes + count * sizeof(tll::Color));
+    }
+
+    // 同じ色の連続を [個数-1][Color] で表す
+    std::vector<uint8_t> encodeRle(const tll::Surface& frame)
+    {
+        std::vector<uint8_t> out;
+        const std::vector<tll::Color>& pixels = frame.pixels;
+
+        for (size_t pos = 0; pos < pixels.size(); )
+        {
+            size_t run = 1;
+            while (pos + run < pixels.size() && run < 256 && same(pixels[pos + run], pixels[pos]))
+                run++;
+
+            out.push_back(static_cast<uint8_t>(run - 1));
+            append(out, &pixels[pos], 1);
+            pos += run;
+        }
+
+        return out;
+    }
+
+    // 前のフレームと同じ画素は読み飛ばし、変わった画素だけを並べる
+    std::vector<uint8_t> encodeDelta(const tll::Surface& prev, const tll::Surface& frame)
+    {
+        std::vector<uint8_t> out;
+        const std::vector<tll::Color>& pixels = frame.pixels;
+
+        // 末尾の変化の無い画素は書かなくても前のフレームのまま残る
+        size_t keep = 0;
+
+        for (size_t pos = 0; pos < pixels.size(); )
+        {
+            bool changed = !same(pixels[pos], prev.pixels[pos]);
+
+            size_t run = 1;
+            while (pos + run < pixels.size() && run < vid::MAX_RUN
+                && !same(pixels[pos + run], prev.pixels[pos + run]) == changed)
+                run++;
+
+            out.push_back(static_cast<uint8_t>((run - 1) | (changed ? vid::LITERAL : 0)));
+            if (changed)
+            {
+                append(out, &pixels[pos], run);
+                keep = out.size();
+            }
+
+            pos += run;
+        }
+
+        out.resize(keep);
+        return out;
+    }
+
+    /* フレームごとに最も小さくなる符号化方式を選んで書き出す */
+    class FrameFileWriter
+    {
+    public:
+        FrameFileWriter(const std::string& path, uint16_t width, uint16_t height, double fps, uint32_t key_interval)
+            : out_(path, std::ios::binary | std::ios::trunc)
+            , offset_(0)
+            , key_(0)
+        {
+            std::memcpy(this->header_.magic, vid::MAGIC, sizeof(vid::MAGIC));
+            this->header_.version = vid::VERSION;
+            this->header_.width = width;
+            this->header_.height = height;
+            this->header_.frame_count = 0;
+            this->header_.fps_den = 1000;
+            this->header_.fps_num = static_cast<uint32_t>(std::lround(fps * this->header_.fps_den));
+            this->header_.key_interval = std::max<uint32_t>(key_interval, 1);
+            this->header_.index_offset = 0;
+
+            // ヘッダは最後に書き直す
+            this->write(&this->header_, sizeof(this->header_));
+        }
+
+        bool good() const { return this->out_.good(); }
+
+        void add(const tll::Surface& frame)
+        {
+            uint32_t index = static_cast<uint32_t>(this->frames_.size());
+            size_t raw_size = frame.pixels.size() * sizeof(tll::Color);
+
+            // キーフレームは単独で復元できる形式にし、シーク時に復元するフレーム数を抑える
+            bool key = index % this->header_.key_interval == 0;
+
+            std::vector<uint8_t> data;
+            vid::EFrame type = vid::EFrame::RAW;
+
+            std::vector<uint8_t> rle = encodeRle(frame);
+            if (rle.size() < raw_size)
+            {
+                data = std::move(rle);
+                type = vid::EFrame::RLE;
+            }
+
+            if (!key)
+            {
+                std::vector<uint8_t> delta = encodeDelta(this->prev_, frame);
+                if (delta.size() < (type == vid::EFrame::RAW ? raw_size : data.size()))
+                {
+                    data = std::move(delta);
+                    type = vid::EFrame::DELTA;
+                }
+            }
+
+            if (type == vid::EFrame::RAW)
+                append(data, frame.pixels.data(), frame.pixels.size());
+
+            if (type != vid::EFrame::DELTA)
+                this->key_ = index;
+
+            vid::FrameEntry entry{};
+            entry.offset = this->write(data.data(), data.size());
+            entry.size = static_cast<uint32_t>(data.size());
+            entry.key = this->key_;
+            entry.type = type;
+            this->frames_.push_back(entry);
+
+            this->counts_[static_cast<uint8_t>(type)]++;
+            this->prev_ = frame;
+        }
+
+        // フレームの表とヘッダを書き出す
+        bool finish()
+        {
+            // フレームの表は8バイト境界に置く
+            static const char zero[8] = {};
+            this->write(zero, (8 - this->offset_ % 8) % 8);
+
+            this->header_.frame_count = static_cast<uint32_t>(this->frames_.size());
+            this->header_.index_offset = this->write(this->frames_.data(), this->frames_.size() * sizeof(vid::FrameEntry));
+
+            this->out_.seekp(0);
+            this->out_.write(reinterpret_cast<const char*>(&this->header_), sizeof(this->header_));
+            this->out_.close();
+
+            return !this->out_.fail();
+        }
+
+        uint32_t frameCount() const { return static_cast<uint32_t>(this->frames_.size()); }
+        uint64_t size() const { return this->offset_; }
+        uint32_t count(vid::EFrame type) const { return this->counts_[static_cast<uint8_t>(type)]; }
+
+    private:
+        uint64_t write(const void* data, uint64_t bytes)
+        {
+            uint64_t offset = this->offset_;
+
+            this->out_.write(static_cast<const char*>(data), bytes);
+            this->offset_ += bytes;
+
+            return offset;
+        }
+
+        std::ofstream out_;
+        uint64_t offset_;
+
+        vid::Header header_{};
+        std::vector<vid::FrameEntry> frames_;
+
+        tll::Surface prev_;
+        uint32_t key_;    // 直近の単独で復元できるフレーム
+        uint32_t counts_[3] = {};
+    };
+
+    void usage(const char* argv0)
+    {
+        std::cout << "Usage: " << argv0 << " INPUT OUTPUT.tllvid [--size WxH] [--fps N] [--key N]" << std::endl
+                  << "  --size WxH  Panel resolution (default 64x32)" << std::endl
+                  << "  --fps N     Output frame rate (default: source rate, at most 30)" << std::endl
+                  << "  --key N     Self-contained frame interval, bounds the cost of seeking (default 30)" << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::string in_path = argv[1];
+    std::string out_path = argv[2];
+
+    unsigned width = 64;
+    unsigned height = 32;
+    double fps = 0.0;
+    uint32_t key_interval = 30;
+
+    for (int i = 3; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+        {
+            if (sscanf(argv[++i], "%ux%u", &width, &height) != 2 || width == 0 || height == 0 || width > UINT16_MAX || height > UINT16_MAX)
+            {
+                usage(argv[0]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc)
+            fps = std::atof(argv[++i]);
+        else if (strcmp(argv[i], "--key") == 0 && i + 1 < argc)
+            key_interval = static_cast<uint32_t>(std::max(std::atoi(argv[++i]), 1));
+        else
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    cv::VideoCapture capture;
+    if (!capture.open(in_path))
+    {
+        std::cerr << "[ERROR] Failed to open " << in_path << std::endl;
+        return 1;
+    }
+
+    double src_fps = capture.get(cv::CAP_PROP_FPS);
+    if (!(src_fps > 0.0))
+        src_fps = 30.0;
+
+    if (!(fps > 0.0))
+        fps = std::min(src_fps, 30.0);
+
+    FrameFileWriter writer(out_path, static_cast<uint16_t>(width), static_cast<uint16_t>(height), fps, key_interval);
+    if (!writer.good())
+    {
+        std::cerr << "[ERROR] Failed to create " << out_path << std::endl;
+        return 1;
+    }
+
+    cv::Mat frame;
+    cv::Mat scaled;
+    tll::Surface surface;
+    surface.resize(static_cast<uint16_t>(width), static_cast<uint16_t>(height));
+
+    // 出力の各フレームの時刻に対応する元のフレームだけをデコードし、間のフレームはgrab()で読み飛ばす
+    uint64_t next = 0;
+    for (uint64_t k = 0; ; k++)
+    {
+        uint64_t source = static_cast<uint64_t>(std::floor(k * src_fps / fps + 1e-6));
+
+        bool ok = true;
+        for (; next <= source && ok; next++)
+            ok = capture.grab();
+
+        if (!ok || !capture.retrieve(frame) || frame.empty())
+            break;
+
+        cv::resize(frame, scaled, cv::Size(width, height), 0, 0, cv::INTER_AREA);
+
+        for (int y = 0; y < scaled.rows; y++)
+        {
+            const cv::Vec3b* src = scaled.ptr<cv::Vec3b>(y);
+            tll::Color* dst = &surface.pixels[y * surface.width];
+
+            for (int x = 0; x < scaled.cols; x++)
+                dst[x] = tll::Color(src[x][2], src[x][1], src[x][0]);
+        }
+
+        writer.add(surface);
+    }
+
+    if (writer.frameCount() == 0 || !writer.finish())
+    {
+        std::cerr << "[ERROR] Failed to write " << out_path << std::endl;
+        return 1;
+    }
+
+    uint64_t raw = static_cast<uint64_t>(writer.frameCount()) * width * height * sizeof(tll::Color);
+
+    std::cout << "Wrote " << writer.frameCount() << " frames at " << fps << " fps (" << width << "x" << height << ") to " << out_path << std::endl
+              << "  raw " << writer.count(vid::EFrame::RAW) << ", rle " << writer.count(vid::EFrame::RLE)
+              << ", delta " << writer.count(vid::EFrame::DELTA) << std::endl
+              << "  " << writer.size() << " bytes (" << (100.0 * writer.size() / raw) << "% of raw)" << std::endl;
+
+    return 0;
+}